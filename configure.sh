@@ -35,7 +35,7 @@ elif [ $check = undefined ]
 then
   check=no
 fi
-CFLAGS="-Wall -Wextra -std=c++11"
+CFLAGS="-Wall -Wextra -std=c++11 -pthread"
 if [ $debug = yes ]
 then
   CFLAGS="$CFLAGS -g3"
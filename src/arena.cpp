@@ -0,0 +1,101 @@
+/*------------------------------------------------------------------------*/
+/*! \file arena.cpp
+    \brief contains the slab arena used by polynomials for monomial payloads.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include "arena.h"
+
+//***************************************************************************************
+PolyArena::PolyArena(size_t slabSize) {
+	for (size_t i = 0; i < numClasses; i++) {
+		this->freeLists[i] = NULL;
+	}
+	this->cursor = NULL;
+	this->slabEnd = NULL;
+	this->largeBlocks = NULL;
+	this->slabSize = (slabSize < maxBlockSize) ? maxBlockSize : slabSize;
+	this->reservedBytes = 0;
+}
+
+//***************************************************************************************
+PolyArena::~PolyArena() {
+	this->reset();
+}
+
+//***************************************************************************************
+void* PolyArena::allocate(size_t bytes) {
+	if (!fits(bytes)) {  // Too big for size classes, chain it for reset().
+		LargeBlock* large = static_cast<LargeBlock*>(::operator new(sizeof(LargeBlock) + bytes));
+		large->prev = NULL;
+		large->next = this->largeBlocks;
+		if (large->next != NULL) large->next->prev = large;
+		this->largeBlocks = large;
+		return large + 1;
+	}
+	size_t sizeClass = (bytes - 1) / granularity;
+	FreeBlock* block = this->freeLists[sizeClass];
+	if (block != NULL) {  // Reuse previously freed block.
+		this->freeLists[sizeClass] = block->next;
+		return block;
+	}
+	size_t blockSize = (sizeClass + 1) * granularity;
+	if (this->cursor == NULL || (size_t)(this->slabEnd - this->cursor) < blockSize) this->newSlab(blockSize);
+	void* result = this->cursor;
+	this->cursor += blockSize;
+	return result;
+}
+
+//***************************************************************************************
+void PolyArena::deallocate(void* p, size_t bytes) {
+	if (p == NULL) return;
+	if (!fits(bytes)) {
+		LargeBlock* large = static_cast<LargeBlock*>(p) - 1;
+		if (large->prev != NULL) large->prev->next = large->next;
+		else this->largeBlocks = large->next;
+		if (large->next != NULL) large->next->prev = large->prev;
+		::operator delete(large);
+		return;
+	}
+	size_t sizeClass = (bytes - 1) / granularity;
+	FreeBlock* block = static_cast<FreeBlock*>(p);
+	block->next = this->freeLists[sizeClass];
+	this->freeLists[sizeClass] = block;
+}
+
+//***************************************************************************************
+void PolyArena::newSlab(size_t bytes) {
+	size_t size = (bytes < this->slabSize) ? this->slabSize : bytes;
+	char* slab = static_cast<char*>(::operator new(size));
+	this->slabs.push_back(slab);
+	this->cursor = slab;
+	this->slabEnd = slab + size;
+	this->reservedBytes += size;
+}
+
+//***************************************************************************************
+void PolyArena::reset() {
+	for (size_t i = 0; i < this->slabs.size(); i++) {
+		::operator delete(this->slabs[i]);
+	}
+	this->slabs.clear();
+	while (this->largeBlocks != NULL) {
+		LargeBlock* next = this->largeBlocks->next;
+		::operator delete(this->largeBlocks);
+		this->largeBlocks = next;
+	}
+	for (size_t i = 0; i < numClasses; i++) {
+		this->freeLists[i] = NULL;
+	}
+	this->cursor = NULL;
+	this->slabEnd = NULL;
+	this->reservedBytes = 0;
+}
+
+//***************************************************************************************
+size_t PolyArena::getReservedBytes() const {
+	return this->reservedBytes;
+}
@@ -0,0 +1,143 @@
+/*------------------------------------------------------------------------*/
+/*! \file arena.h
+    \brief contains the slab arena used by polynomials for monomial payloads.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+// std includes.
+#include <stdlib.h>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Class for a slab arena with size classes. Freed blocks are kept in one free list per size class
+// and all memory is returned at once by reset() or the destructor. Blocks larger than the biggest size class are
+// taken from the system heap one by one, they are chained so that reset() releases them as well.
+// Not thread-safe, every polynomial owns its own arena.
+class PolyArena {
+
+	public:
+		//*********************** Constructors  ******************************************************//
+		
+		/** Constructor.
+
+			@param slabSize size_t number of bytes requested from the system per slab
+		*/
+		PolyArena(size_t slabSize = 1 << 16);
+		
+		/** Destructor. Releases all slabs. */
+		virtual ~PolyArena();
+		
+		//*********************** Allocation  ******************************************************//
+		
+		/** Return whether a block of the given size is served by a size class of the arena.
+
+			@param bytes size_t
+			@return bool
+		*/
+		static bool fits(size_t bytes) { return bytes > 0 && bytes <= maxBlockSize; }
+		
+		/** Allocate a block of given size. Blocks larger than the biggest size class are taken from the system heap
+			and released by deallocate or reset.
+
+			@param bytes size_t
+			@return void* pointer to the block
+		*/
+		void* allocate(size_t bytes);
+		
+		/** Return a block to the free list of its size class. The size has to be the same as used for allocation.
+
+			@param p void* pointer to the block
+			@param bytes size_t
+		*/
+		void deallocate(void* p, size_t bytes);
+		
+		/** Release all blocks at once, including the large blocks from the system heap. All pointers handed out by the arena get invalid. */
+		void reset();
+		
+		/** Get the number of bytes currently reserved in slabs.
+
+			@return size_t
+		*/
+		size_t getReservedBytes() const;
+	
+	private:
+		// Granularity of size classes in bytes and size of the biggest class.
+		static const size_t granularity = 16;
+		static const size_t maxBlockSize = 1024;
+		static const size_t numClasses = maxBlockSize / granularity;
+		
+		// Node used for chaining freed blocks.
+		struct FreeBlock {
+			FreeBlock* next;
+		};
+		
+		// Header in front of every large block, chaining all large blocks which are still allocated.
+		// Its size keeps the block behind it aligned like memory from operator new.
+		struct alignas(16) LargeBlock {
+			LargeBlock* prev;
+			LargeBlock* next;
+		};
+		
+		/** Request a new slab from the system heap.
+
+			@param bytes size_t minimal usable size of the slab
+		*/
+		void newSlab(size_t bytes);
+		
+		// Heads of the free lists, one per size class.
+		FreeBlock* freeLists[numClasses];
+		
+		// All slabs requested from the system and the unused part of the current slab.
+		std::vector<char*> slabs;
+		char* cursor;
+		char* slabEnd;
+		
+		// Large blocks which are still allocated.
+		LargeBlock* largeBlocks;
+		size_t slabSize;
+		size_t reservedBytes;
+};
+
+// Allocator adaptor for standard containers, forwarding all requests to a PolyArena.
+template <class T>
+class ArenaAllocator {
+
+	public:
+		typedef T value_type;
+		
+		// Containers moved or swapped take their arena with them, see Polynom's move operations.
+		typedef std::true_type propagate_on_container_move_assignment;
+		typedef std::true_type propagate_on_container_swap;
+		
+		ArenaAllocator(PolyArena* arena) : arena(arena) {}
+		
+		template <class U>
+		ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+		
+		T* allocate(size_t n) {
+			return static_cast<T*>(this->arena->allocate(n * sizeof(T)));
+		}
+		
+		void deallocate(T* p, size_t n) {
+			this->arena->deallocate(p, n * sizeof(T));
+		}
+		
+		template <class U>
+		bool operator==(const ArenaAllocator<U>& other) const { return this->arena == other.arena; }
+		
+		template <class U>
+		bool operator!=(const ArenaAllocator<U>& other) const { return this->arena != other.arena; }
+		
+		// Arena serving all requests.
+		PolyArena* arena;
+};
+
+#endif /* ARENA_H_ */
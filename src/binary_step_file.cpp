@@ -0,0 +1,286 @@
+/*------------------------------------------------------------------------*/
+/*! \file binary_step_file.cpp
+    \brief contains the reader and the converter for step files in the
+    compact binary format.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "binary_step_file.h"
+#include "step_file.h"
+
+// Magic number and version at the start of every binary step file.
+static const char BINARY_STEP_MAGIC[4] = {'F', 'P', 'S', 'B'};
+static const uint8_t BINARY_STEP_VERSION = 1;
+
+//***************************************************************************************
+BinaryStepFile::BinaryStepFile(const std::string& filename) : file(filename) {
+	this->pos = this->end = NULL;
+	this->opened = false;
+	this->corrupted = false;
+	this->maxVarIndex = 0;
+	this->modulus = 0;
+	this->specBegin = this->stepsBegin = NULL;
+	this->sum = 0;
+	if (!this->file.isOpen()) return;
+	this->pos = reinterpret_cast<const uint8_t*>(this->file.getData());
+	this->end = this->pos + this->file.getLength();
+	if (this->file.getLength() < sizeof(BINARY_STEP_MAGIC) + 1 || std::memcmp(this->pos, BINARY_STEP_MAGIC, sizeof(BINARY_STEP_MAGIC)) != 0) {
+		std::cout << "Error reading file " << filename << ". It is not a binary step file." << std::endl;
+		return;
+	}
+	this->pos += sizeof(BINARY_STEP_MAGIC);
+	if (*this->pos++ != BINARY_STEP_VERSION) {
+		std::cout << "Error reading file " << filename << ". Unsupported version of the binary step format." << std::endl;
+		return;
+	}
+	uint64_t maxVar = 0;
+	if (!this->readVarint(maxVar) || !this->readCoef(this->coef)) {
+		std::cout << "Error reading file " << filename << ". The file is truncated or corrupted." << std::endl;
+		this->truncated();
+		return;
+	}
+	this->maxVarIndex = maxVar;
+	this->modulus = this->coef.get_mpz();
+	// Skip the specification polynomial, it is read on demand by readSpec.
+	this->specBegin = this->pos;
+	uint64_t count = 0;
+	if (!this->readVarint(count)) this->truncated();
+	for (uint64_t i = 0; i < count; i++) {
+		if (!this->readMonom()) {
+			this->truncated();
+			break;
+		}
+	}
+	this->stepsBegin = this->pos;
+	this->opened = true;
+}
+
+//***************************************************************************************
+BinaryStepFile::~BinaryStepFile() {
+}
+
+//***************************************************************************************
+bool BinaryStepFile::isBinary(const std::string& filename) {
+	std::ifstream infile(filename, std::ios::binary);
+	char magic[sizeof(BINARY_STEP_MAGIC)];
+	if (!infile.read(magic, sizeof(magic))) return false;
+	return std::memcmp(magic, BINARY_STEP_MAGIC, sizeof(BINARY_STEP_MAGIC)) == 0;
+}
+
+//***************************************************************************************
+bool BinaryStepFile::isOpen() const {
+	return this->opened;
+}
+
+//***************************************************************************************
+const std::string& BinaryStepFile::getFilename() const {
+	return this->file.getFilename();
+}
+
+//***************************************************************************************
+int BinaryStepFile::getMaxVarIndex() const {
+	return this->maxVarIndex;
+}
+
+//***************************************************************************************
+const mpz_class& BinaryStepFile::getModulus() const {
+	return this->modulus;
+}
+
+//***************************************************************************************
+bool BinaryStepFile::readSpec(Polynom& spec) {
+	if (!this->opened) return false;
+	const uint8_t* cursor = this->pos;
+	this->pos = this->specBegin;
+	uint64_t count = 0;
+	bool complete = this->readVarint(count);
+	for (uint64_t i = 0; complete && i < count; i++) {
+		complete = this->readMonom();
+		if (complete) spec.addMonom(Monom(this->vars.data(), this->vars.size(), this->sum, this->coef));
+	}
+	this->pos = cursor;
+	return complete;
+}
+
+//***************************************************************************************
+bool BinaryStepFile::nextStep(varIndex& leadingVar, std::list<Monom>& tail) {
+	tail.clear();
+	leadingVar = 0;
+	if (!this->opened || this->pos >= this->end) return false;
+	uint64_t count = 0;
+	if (!this->readVarint(count)) {
+		this->truncated();
+		return false;
+	}
+	for (uint64_t i = 0; i < count; i++) {
+		if (!this->readMonom()) {
+			this->truncated();
+			return false;
+		}
+		if (i == 0) leadingVar = this->vars.empty() ? 0 : this->vars.back();
+		else tail.push_back(Monom(this->vars.data(), this->vars.size(), this->sum, this->coef));
+	}
+	return true;
+}
+
+//***************************************************************************************
+void BinaryStepFile::rewind() {
+	if (this->opened) this->pos = this->stepsBegin;
+}
+
+//***************************************************************************************
+bool BinaryStepFile::isCorrupted() const {
+	return this->corrupted;
+}
+
+//***************************************************************************************
+bool BinaryStepFile::readVarint(uint64_t& value) {
+	value = 0;
+	for (int shift = 0; this->pos < this->end && shift < 64; shift += 7) {
+		uint8_t byte = *this->pos++;
+		value |= (uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) return true;
+	}
+	return false;
+}
+
+//***************************************************************************************
+bool BinaryStepFile::readCoef(Coef& coef) {
+	uint64_t tag = 0;
+	if (!this->readVarint(tag)) return false;
+	uint64_t limbCount = tag >> 1;
+	bool negative = tag & 1;
+	if (limbCount == 0) {
+		coef = Coef(0L);
+		return true;
+	}
+	if (limbCount == 1) {
+		uint64_t value = 0;
+		if (!this->readVarint(value)) return false;
+		uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+		if (value <= limit) {
+			coef = Coef(negative ? (long)(0 - value) : (long)value);
+			return true;
+		}
+		this->limbs.assign(1, value);
+	} else {
+		if (limbCount > (uint64_t)(this->end - this->pos)) return false;  // Every limb takes at least one byte.
+		this->limbs.resize(limbCount);
+		for (uint64_t i = 0; i < limbCount; i++) {
+			if (!this->readVarint(this->limbs[i])) return false;
+		}
+	}
+	mpz_import(this->big.get_mpz_t(), this->limbs.size(), -1, sizeof(uint64_t), 0, 0, this->limbs.data());
+	if (negative) this->big = -this->big;
+	coef = Coef(this->big);
+	return true;
+}
+
+//***************************************************************************************
+bool BinaryStepFile::readMonom() {
+	if (!this->readCoef(this->coef)) return false;
+	uint64_t count = 0;
+	if (!this->readVarint(count) || count > (uint64_t)(this->end - this->pos)) return false;
+	this->vars.resize(count);
+	this->sum = 0;
+	for (uint64_t i = 0; i < count; i++) {
+		uint64_t var = 0;
+		if (!this->readVarint(var) || var > INT_MAX) return false;
+		this->vars[i] = var;
+		this->sum += var;
+	}
+	return true;
+}
+
+//***************************************************************************************
+void BinaryStepFile::truncated() {
+	this->corrupted = true;
+	this->pos = this->end;
+}
+
+//***************************************************************************************
+// Append value as varint to out.
+static void writeVarint(std::string& out, uint64_t value) {
+	while (value >= 0x80) {
+		out.push_back((char)((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	out.push_back((char)value);
+}
+
+//***************************************************************************************
+// Append value as coefficient to out, limbs is a reusable buffer.
+static void writeCoef(std::string& out, const mpz_class& value, std::vector<uint64_t>& limbs) {
+	size_t limbCount = (mpz_sizeinbase(value.get_mpz_t(), 2) + 63) / 64;
+	limbs.resize(limbCount);
+	mpz_export(limbs.data(), &limbCount, -1, sizeof(uint64_t), 0, 0, value.get_mpz_t());  // Writes no limbs for 0.
+	writeVarint(out, (limbCount << 1) | (sgn(value) < 0 ? 1 : 0));
+	for (size_t i = 0; i < limbCount; i++) writeVarint(out, limbs[i]);
+}
+
+//***************************************************************************************
+// Append all monomials of the polynomial read by scanner to out, preceded by their number.
+static void writePoly(std::string& out, MonomScanner& scanner, bool sort, std::string& body, std::vector<uint64_t>& limbs) {
+	uint64_t count = 0;
+	body.clear();
+	while (scanner.next()) {
+		varIndex* vars = scanner.getVars();
+		int size = scanner.getSize();
+		if (sort) std::sort(vars, vars + size);
+		writeCoef(body, scanner.getCoef().get_mpz(), limbs);
+		writeVarint(body, size);
+		for (int i = 0; i < size; i++) writeVarint(body, vars[i]);
+		count++;
+	}
+	writeVarint(out, count);
+	out.append(body);
+}
+
+//***************************************************************************************
+bool convertStepFileToBinary(const std::string& textFile, const std::string& binaryFile) {
+	StepFile in(textFile);
+	if (!in.isOpen()) {
+		std::cout << "Error opening file " << textFile << ". Make sure the filename is correct." << std::endl;
+		return false;
+	}
+	std::ofstream out(binaryFile, std::ios::binary | std::ios::trunc);
+	if (!out.is_open()) {
+		std::cout << "Error opening file " << binaryFile << " for writing." << std::endl;
+		return false;
+	}
+	std::string buffer;
+	std::string body;
+	std::vector<uint64_t> limbs;
+	buffer.append(BINARY_STEP_MAGIC, sizeof(BINARY_STEP_MAGIC));
+	buffer.push_back((char)BINARY_STEP_VERSION);
+	writeVarint(buffer, in.getMaxVarIndex());
+	writeCoef(buffer, in.getModulus(), limbs);
+	MonomScanner spec = in.getSpec();
+	writePoly(buffer, spec, true, body, limbs);
+	const char* begin;
+	const char* end;
+	while (in.nextStep(begin, end)) {
+		MonomScanner step(begin, end);
+		writePoly(buffer, step, false, body, limbs);
+		if (buffer.size() >= (1 << 20)) {
+			out.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+	}
+	out.write(buffer.data(), buffer.size());
+	out.close();
+	if (!out) {
+		std::cout << "Error writing file " << binaryFile << "." << std::endl;
+		return false;
+	}
+	return true;
+}
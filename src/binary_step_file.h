@@ -0,0 +1,171 @@
+/*------------------------------------------------------------------------*/
+/*! \file binary_step_file.h
+    \brief contains the reader and the converter for step files in the
+    compact binary format.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#ifndef BINARY_STEP_FILE_H_
+#define BINARY_STEP_FILE_H_
+
+// std includes.
+#include <stdint.h>
+#include <stdlib.h>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <gmpxx.h>
+
+// Local includes.
+#include "coef.h"
+#include "mapped_file.h"
+#include "monom.h"
+#include "polynom.h"
+
+// Binary counterpart of the text step files (see Benchmarks/benchmark_explanation.txt). All numbers are unsigned LEB128 varints.
+//
+//   file     := "FPSB" version(1 byte) maxVarIndex modulus spec step*
+//   spec     := monomCount monom*                   (variables sorted ascending)
+//   step     := monomCount monom*                   (first monom gives the replaced variable, as in the text format)
+//   monom    := coef varCount varIndex*
+//   coef     := (limbCount << 1 | negative) limb*   (64 bit limbs of the absolute value, least significant first)
+//
+// The modulus is stored as coef, 0 if coefficients are not reduced.
+class BinaryStepFile {
+
+	public:
+		//*********************** Constructors  ******************************************************//
+
+		/** Constructor. Maps the file and reads the header up to the specification polynomial.
+
+			@param filename std::string
+		*/
+		BinaryStepFile(const std::string& filename);
+
+		/** Destructor. */
+		virtual ~BinaryStepFile();
+
+		BinaryStepFile(const BinaryStepFile&) = delete;
+		BinaryStepFile& operator=(const BinaryStepFile&) = delete;
+
+		/** Return whether the file starts with the magic number of the binary format.
+
+			@param filename std::string
+			@return bool
+		*/
+		static bool isBinary(const std::string& filename);
+
+		//*********************** Header  ******************************************************//
+
+		/** Return whether the file could be opened and is in the binary format.
+
+			@return bool
+		*/
+		bool isOpen() const;
+
+		/** Get the name of the file.
+
+			@return std::string
+		*/
+		const std::string& getFilename() const;
+
+		/** Get the maximum variable index.
+
+			@return int
+		*/
+		int getMaxVarIndex() const;
+
+		/** Get the modulus, 0 if coefficients are not reduced.
+
+			@return mpz_class
+		*/
+		const mpz_class& getModulus() const;
+
+		//*********************** Polynomials  ******************************************************//
+
+		/** Add the monomials of the specification polynomial to spec.
+
+			@param spec Polynom
+			@return bool false if the file is truncated
+		*/
+		bool readSpec(Polynom& spec);
+
+		/** Read the next substitution step.
+
+			@param leadingVar varIndex& variable which is replaced
+			@param tail std::list<Monom>& receives the replacing monomials
+			@return bool false if there are no more steps
+		*/
+		bool nextStep(varIndex& leadingVar, std::list<Monom>& tail);
+
+		/** Continue with the first step again. */
+		void rewind();
+
+		/** Return whether reading stopped early because the file is truncated or corrupted.
+
+			@return bool
+		*/
+		bool isCorrupted() const;
+
+	private:
+		/** Read a varint at the current position.
+
+			@param value uint64_t&
+			@return bool false if the file ends before the varint
+		*/
+		bool readVarint(uint64_t& value);
+
+		/** Read a coefficient at the current position.
+
+			@param coef Coef&
+			@return bool false if the file ends before the coefficient
+		*/
+		bool readCoef(Coef& coef);
+
+		/** Read a monomial at the current position into vars and coef.
+
+			@return bool false if the file ends before the monomial
+		*/
+		bool readMonom();
+
+		/** Mark the file as corrupted and move the position to its end. Nothing is printed, as steps may be read on a background thread. */
+		void truncated();
+
+		// Contents of the file.
+		MappedFile file;
+		const uint8_t* pos;
+		const uint8_t* end;
+
+		// Header.
+		bool opened;
+		bool corrupted;
+		int maxVarIndex;
+		mpz_class modulus;
+
+		// Start of the specification polynomial and of the first step.
+		const uint8_t* specBegin;
+		const uint8_t* stepsBegin;
+
+		// Current monomial, reused for all monomials.
+		Coef coef;
+		std::vector<varIndex> vars;
+		int sum;
+
+		// Buffers for coefficients exceeding 64 bit.
+		std::vector<uint64_t> limbs;
+		mpz_class big;
+};
+
+/** Convert a step file from the text format into the binary format.
+
+	@param textFile std::string name of the existing text file
+	@param binaryFile std::string name of the binary file to write
+	@return bool false if one of the files could not be opened
+*/
+bool convertStepFileToBinary(const std::string& textFile, const std::string& binaryFile);
+
+#endif /* BINARY_STEP_FILE_H_ */
@@ -0,0 +1,469 @@
+/*------------------------------------------------------------------------*/
+/*! \file coef.cpp
+    \brief contains the class Coef for representing monomial coefficients.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include <cstring>
+#include <iostream>
+
+#include "coef.h"
+
+//***************************************************************************************
+// Set a GMP integer to a 64 bit value, also on platforms where long is only 32 bit wide.
+static void mpzSetInt64(mpz_ptr dst, int64_t value) {
+	if (sizeof(long) >= sizeof(int64_t)) {
+		mpz_set_si(dst, (long)value);
+	} else {
+		uint64_t magnitude = (value < 0) ? -(uint64_t)value : (uint64_t)value;
+		mpz_import(dst, 1, -1, sizeof(uint64_t), 0, 0, &magnitude);
+		if (value < 0) mpz_neg(dst, dst);
+	}
+}
+
+//***************************************************************************************
+Coef::Coef() {
+	this->small = 0;
+	this->kind = SMALL;
+}
+
+//***************************************************************************************
+Coef::Coef(long value) {
+	this->small = value;
+	this->kind = SMALL;
+}
+
+//***************************************************************************************
+Coef::Coef(const mpz_class& value) {
+	if (mpz_fits_slong_p(value.get_mpz_t())) {
+		this->small = mpz_get_si(value.get_mpz_t());
+		this->kind = SMALL;
+	} else {
+		mpz_init_set(&this->big, value.get_mpz_t());
+		this->kind = BIG;
+	}
+}
+
+//***************************************************************************************
+Coef::Coef(const Coef& old) {  // Copy constructor
+	if (old.kind == BIG) {
+		mpz_init_set(&this->big, &old.big);
+	} else if (old.kind == WIDE) {
+		this->wide[0] = old.wide[0];
+		this->wide[1] = old.wide[1];
+	} else {
+		this->small = old.small;
+	}
+	this->kind = old.kind;
+}
+
+//***************************************************************************************
+Coef& Coef::operator=(const Coef& old) {  // Assignment operator.
+	if (this == &old) return *this;
+	if (old.kind == BIG) {
+		if (this->kind == BIG) mpz_set(&this->big, &old.big);
+		else mpz_init_set(&this->big, &old.big);
+	} else {
+		if (this->kind == BIG) mpz_clear(&this->big);
+		if (old.kind == WIDE) {
+			this->wide[0] = old.wide[0];
+			this->wide[1] = old.wide[1];
+		} else {
+			this->small = old.small;
+		}
+	}
+	this->kind = old.kind;
+	return *this;
+}
+
+//***************************************************************************************
+Coef::Coef(Coef&& old) {  // Move constructor
+	this->takeOver(old);
+}
+
+//***************************************************************************************
+Coef& Coef::operator=(Coef&& old) {  // Move assignment operator.
+	if (this == &old) return *this;
+	if (this->kind == BIG && old.kind == BIG) {
+		mpz_swap(&this->big, &old.big);  // old releases our limbs later.
+	} else {
+		if (this->kind == BIG) mpz_clear(&this->big);
+		this->takeOver(old);
+	}
+	return *this;
+}
+
+//***************************************************************************************
+Coef::~Coef() {
+	if (this->kind == BIG) mpz_clear(&this->big);
+}
+
+//***************************************************************************************
+mpz_class Coef::get_mpz() const {
+	mpz_class result;
+	if (this->kind == SMALL) {
+		mpzSetInt64(result.get_mpz_t(), this->small);
+	} else if (this->kind == BIG) {
+		mpz_set(result.get_mpz_t(), &this->big);
+	} else if (this->wide[1] == 0 && sizeof(unsigned long) >= sizeof(uint64_t)) {
+		mpz_set_ui(result.get_mpz_t(), this->wide[0]);
+	} else {
+		mpz_import(result.get_mpz_t(), 2, -1, sizeof(uint64_t), 0, 0, this->wide);
+	}
+	return result;
+}
+
+//***************************************************************************************
+std::string Coef::get_str() const {
+	std::string result;
+	this->appendStr(result);
+	return result;
+}
+
+//***************************************************************************************
+void Coef::appendStr(std::string& out) const {
+	if (this->kind == SMALL) {
+		char digits[20];
+		int count = 0;
+		uint64_t value = this->small < 0 ? 0 - (uint64_t)this->small : (uint64_t)this->small;
+		do {
+			digits[count++] = '0' + value % 10;
+			value /= 10;
+		} while (value != 0);
+		if (this->small < 0) out.push_back('-');
+		while (count > 0) out.push_back(digits[--count]);
+		return;
+	}
+	if (this->kind == WIDE) {
+		out.append(this->get_mpz().get_str());
+		return;
+	}
+	size_t start = out.size();
+	out.resize(start + mpz_sizeinbase(&this->big, 10) + 2);
+	mpz_get_str(&out[start], 10, &this->big);
+	out.resize(start + std::strlen(&out[start]));
+}
+
+//***************************************************************************************
+bool Coef::isZero() const {
+	if (this->kind == SMALL) return this->small == 0;
+	if (this->kind == WIDE) return this->wide[0] == 0 && this->wide[1] == 0;
+	return mpz_sgn(&this->big) == 0;
+}
+
+//***************************************************************************************
+int Coef::sign() const {
+	if (this->kind == SMALL) return (this->small > 0) - (this->small < 0);
+	if (this->kind == WIDE) return this->isZero() ? 0 : 1;
+	return mpz_sgn(&this->big);
+}
+
+//***************************************************************************************
+bool Coef::isZeroModPow2(int bits) const {
+	if (this->kind == SMALL) {  // |small| <= 2^63, so only 0 is divisible by 2^64 or more.
+		if (bits >= 64) return this->small == 0;
+		return ((uint64_t)this->small & ((((uint64_t)1) << bits) - 1)) == 0;
+	}
+	if (this->kind == WIDE) {
+		if (bits >= 128) return this->isZero();
+		if (bits >= 64) return this->wide[0] == 0 && (bits == 64 || (this->wide[1] & ((((uint64_t)1) << (bits - 64)) - 1)) == 0);
+		return (this->wide[0] & ((((uint64_t)1) << bits) - 1)) == 0;
+	}
+	return mpz_sgn(&this->big) == 0 || mpz_scan1(&this->big, 0) >= (mp_bitcnt_t)bits;
+}
+
+//***************************************************************************************
+int Coef::bitSize() const {
+	if (this->kind == SMALL) {
+		uint64_t magnitude = (this->small < 0) ? -(uint64_t)this->small : (uint64_t)this->small;
+		return (magnitude == 0) ? 0 : 64 - __builtin_clzll(magnitude);
+	}
+	if (this->kind == WIDE) {
+		if (this->wide[1] != 0) return 128 - __builtin_clzll(this->wide[1]);
+		return (this->wide[0] == 0) ? 0 : 64 - __builtin_clzll(this->wide[0]);
+	}
+	return (mpz_sgn(&this->big) == 0) ? 0 : (int)mpz_sizeinbase(&this->big, 2);
+}
+
+//***************************************************************************************
+void Coef::add(const Coef& other) {
+	if (this->kind == SMALL && other.kind == SMALL) {
+		int64_t result;
+		if (!__builtin_add_overflow(this->small, other.small, &result)) {
+			this->small = result;
+			return;
+		}
+	}
+	if (this->kind == WIDE || other.kind == WIDE) {
+		uint64_t a[2], b[2], r[2];
+		this->getLimbs(a);
+		other.getLimbs(b);
+		r[0] = a[0] + b[0];
+		r[1] = a[1] + b[1] + (r[0] < a[0]);  // Add carry of lower limb.
+		this->setLimbs(r);
+		return;
+	}
+	mpz_t tmpA, tmpB, result;  // Overflow or GMP operand.
+	mpz_init(tmpA);
+	mpz_init(tmpB);
+	mpz_init(result);
+	mpz_add(result, this->asMpz(tmpA), other.asMpz(tmpB));
+	mpz_clear(tmpA);
+	mpz_clear(tmpB);
+	this->setBig(result);
+	mpz_clear(result);
+}
+
+//***************************************************************************************
+void Coef::mul(const Coef& a, const Coef& b) {
+	if (a.kind == SMALL && b.kind == SMALL) {
+		int64_t result;
+		if (!__builtin_mul_overflow(a.small, b.small, &result)) {
+			this->setSmall(result);
+			return;
+		}
+	}
+	if (a.kind == WIDE || b.kind == WIDE) {
+		uint64_t x[2], y[2], r[2];
+		a.getLimbs(x);
+		b.getLimbs(y);
+		// Product modulo 2^128: full 64x64 product of the lower limbs plus the lower halves of the cross products.
+		unsigned __int128 low = (unsigned __int128)x[0] * y[0];
+		r[0] = (uint64_t)low;
+		r[1] = (uint64_t)(low >> 64) + x[0] * y[1] + x[1] * y[0];
+		this->setLimbs(r);
+		return;
+	}
+	mpz_t tmpA, tmpB, result;  // Overflow or GMP operand. this may alias a or b, so compute into result first.
+	mpz_init(tmpA);
+	mpz_init(tmpB);
+	mpz_init(result);
+	mpz_mul(result, a.asMpz(tmpA), b.asMpz(tmpB));
+	mpz_clear(tmpA);
+	mpz_clear(tmpB);
+	this->setBig(result);
+	mpz_clear(result);
+}
+
+//***************************************************************************************
+void Coef::neg() {
+	if (this->kind == SMALL && this->small != INT64_MIN) {
+		this->small = -this->small;
+	} else if (this->kind == WIDE) {
+		this->wide[0] = ~this->wide[0] + 1;
+		this->wide[1] = ~this->wide[1] + (this->wide[0] == 0);  // Two's complement, carry if lower limb wrapped to 0.
+	} else {
+		mpz_t tmp, result;
+		mpz_init(tmp);
+		mpz_init(result);
+		mpz_neg(result, this->asMpz(tmp));
+		mpz_clear(tmp);
+		this->setBig(result);
+		mpz_clear(result);
+	}
+}
+
+//***************************************************************************************
+void Coef::mod(const mpz_class& modNum) {
+	if (this->kind == WIDE) {
+		int bits = fixedWidthBits(modNum);
+		if (bits > 0) {
+			this->truncate(bits);
+		} else {  // Modulus is no small power of two, take the detour over GMP.
+			this->toInteger();
+			this->mod(modNum);
+			this->toFixedWidth();
+		}
+		return;
+	}
+	if (this->kind == SMALL && sgn(modNum) > 0 && mpz_fits_slong_p(modNum.get_mpz_t())) {
+		int64_t m = mpz_get_si(modNum.get_mpz_t());
+		int64_t r = this->small % m;
+		if (r < 0) r += m;
+		this->small = r;
+		return;
+	}
+	mpz_t tmp, result;
+	mpz_init(tmp);
+	mpz_init(result);
+	mpz_mod(result, this->asMpz(tmp), modNum.get_mpz_t());
+	mpz_clear(tmp);
+	this->setBig(result);
+	mpz_clear(result);
+}
+
+//***************************************************************************************
+void Coef::modWithQuotient(const mpz_class& modNum, Coef& quotient) {
+	if (this->kind == WIDE) {  // Quotient of the non-negative integer represented by the fixed-width value.
+		this->toInteger();
+		this->modWithQuotient(modNum, quotient);
+		this->toFixedWidth();
+		return;
+	}
+	if (this->kind == SMALL && sgn(modNum) > 0 && mpz_fits_slong_p(modNum.get_mpz_t())) {
+		int64_t m = mpz_get_si(modNum.get_mpz_t());
+		int64_t q = this->small / m;
+		int64_t r = this->small % m;
+		if (r < 0) {  // Round quotient towards minus infinity.
+			r += m;
+			--q;
+		}
+		this->small = r;
+		quotient.setSmall(q);
+		quotient.neg();  // after - before = -q * modNum.
+		return;
+	}
+	mpz_t tmp, q, r;
+	mpz_init(tmp);
+	mpz_init(q);
+	mpz_init(r);
+	mpz_fdiv_qr(q, r, this->asMpz(tmp), modNum.get_mpz_t());
+	mpz_neg(q, q);
+	mpz_clear(tmp);
+	this->setBig(r);
+	quotient.setBig(q);
+	mpz_clear(q);
+	mpz_clear(r);
+}
+
+//***************************************************************************************
+void Coef::toFixedWidth() {
+	if (this->kind == WIDE) return;
+	uint64_t limbs[2];
+	this->getLimbs(limbs);
+	this->setLimbs(limbs);
+}
+
+//***************************************************************************************
+void Coef::toInteger() {
+	if (this->kind != WIDE) return;
+	if (this->wide[1] == 0 && this->wide[0] <= (uint64_t)INT64_MAX) {
+		this->small = (int64_t)this->wide[0];
+		this->kind = SMALL;
+		return;
+	}
+	uint64_t limbs[2] = {this->wide[0], this->wide[1]};
+	mpz_init(&this->big);
+	mpz_import(&this->big, 2, -1, sizeof(uint64_t), 0, 0, limbs);
+	this->kind = BIG;
+}
+
+//***************************************************************************************
+void Coef::truncate(int bits) {
+	if (this->kind == SMALL) {
+		if (bits < 63) {  // Two's complement, the masked value is the non-negative remainder.
+			this->small &= (((int64_t)1) << bits) - 1;
+		} else if (this->small < 0) {  // Remainder 2^bits + small does not fit into 64 bit.
+			mpz_t tmp;
+			mpz_init(tmp);
+			mpzSetInt64(tmp, this->small);
+			mpz_fdiv_r_2exp(tmp, tmp, bits);
+			this->setBig(tmp);
+			mpz_clear(tmp);
+		}
+		return;
+	}
+	if (this->kind == BIG) {
+		mpz_fdiv_r_2exp(&this->big, &this->big, bits);
+		if (mpz_fits_slong_p(&this->big)) this->setSmall(mpz_get_si(&this->big));  // Demote.
+		return;
+	}
+	if (bits >= 128) return;
+	if (bits <= 64) {
+		this->wide[1] = 0;
+		if (bits < 64) this->wide[0] &= (((uint64_t)1) << bits) - 1;
+	} else {
+		this->wide[1] &= (((uint64_t)1) << (bits - 64)) - 1;
+	}
+}
+
+//***************************************************************************************
+int Coef::fixedWidthBits(const mpz_class& modNum) {
+	if (sgn(modNum) <= 0) return 0;
+	if (mpz_popcount(modNum.get_mpz_t()) != 1) return 0;  // Not a power of two.
+	int bits = mpz_scan1(modNum.get_mpz_t(), 0);
+	if (bits < 1 || bits > 128) return 0;
+	return bits;
+}
+
+//***************************************************************************************
+void Coef::setSmall(int64_t value) {
+	if (this->kind == BIG) mpz_clear(&this->big);
+	this->small = value;
+	this->kind = SMALL;
+}
+
+//***************************************************************************************
+void Coef::setBig(mpz_ptr value) {
+	if (mpz_fits_slong_p(value)) {  // Demote.
+		this->setSmall(mpz_get_si(value));
+		return;
+	}
+	if (this->kind != BIG) {
+		mpz_init(&this->big);
+		this->kind = BIG;
+	}
+	mpz_swap(&this->big, value);
+}
+
+//***************************************************************************************
+mpz_srcptr Coef::asMpz(mpz_ptr tmp) const {
+	if (this->kind == BIG) return &this->big;
+	if (this->kind == SMALL) {
+		mpzSetInt64(tmp, this->small);
+	} else {
+		mpz_import(tmp, 2, -1, sizeof(uint64_t), 0, 0, this->wide);
+	}
+	return tmp;
+}
+
+//***************************************************************************************
+void Coef::takeOver(Coef& old) {
+	if (old.kind == BIG) {
+		this->big = old.big;  // Shallow copy, the limbs now belong to this.
+	} else if (old.kind == WIDE) {
+		this->wide[0] = old.wide[0];
+		this->wide[1] = old.wide[1];
+	} else {
+		this->small = old.small;
+	}
+	this->kind = old.kind;
+	old.small = 0;
+	old.kind = SMALL;
+}
+
+//***************************************************************************************
+void Coef::getLimbs(uint64_t limbs[2]) const {
+	if (this->kind == WIDE) {
+		limbs[0] = this->wide[0];
+		limbs[1] = this->wide[1];
+	} else if (this->kind == SMALL) {  // Sign extend.
+		limbs[0] = (uint64_t)this->small;
+		limbs[1] = (this->small < 0) ? ~((uint64_t)0) : 0;
+	} else {
+		mpz_t rem;
+		mpz_init(rem);
+		mpz_fdiv_r_2exp(rem, &this->big, 128);  // Non-negative remainder modulo 2^128.
+		limbs[0] = limbs[1] = 0;
+		mpz_export(limbs, NULL, -1, sizeof(uint64_t), 0, 0, rem);
+		mpz_clear(rem);
+	}
+}
+
+//***************************************************************************************
+void Coef::setLimbs(const uint64_t limbs[2]) {
+	uint64_t low = limbs[0], high = limbs[1];  // limbs may point to this->wide.
+	if (this->kind == BIG) mpz_clear(&this->big);
+	this->wide[0] = low;
+	this->wide[1] = high;
+	this->kind = WIDE;
+}
+
+//***************************************************************************************
+std::ostream& operator<<(std::ostream& stdout, const Coef& obj) {
+	stdout << obj.get_str();
+	return stdout;
+}
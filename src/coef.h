@@ -0,0 +1,247 @@
+/*------------------------------------------------------------------------*/
+/*! \file coef.h
+    \brief contains the class Coef for representing monomial coefficients.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#ifndef COEF_H_
+#define COEF_H_
+
+// std includes.
+#include <stdlib.h>
+#include <cstdint>
+#include <string>
+
+// Gnu multiprecision library.
+#include <gmpxx.h>
+
+// Class to represent a monomial coefficient. A coefficient is kept in one of three forms:
+// SMALL: a 64 bit signed integer. Default form, used as long as the value fits.
+// BIG: an arbitrary precision GMP integer. Arithmetic on SMALL values promotes to BIG on overflow and
+//      BIG results are demoted back to SMALL as soon as they fit again.
+// WIDE: a fixed-width 128 bit unsigned integer with wrapping arithmetic (the value modulo 2^128).
+//      Fixed-width coefficients are used by polynomials reducing modulo 2^k with k <= 128: since 2^k divides 2^128,
+//      wrapping arithmetic followed by truncate(k) yields the same value as GMP arithmetic followed by mpz_mod.
+class Coef {
+
+	public:
+		//*********************** Constructors  ******************************************************//
+		
+		/** Default Constructor, value 0. Does not allocate. */
+		Coef();
+		
+		/** Constructor from integer.
+
+			@param value long
+		*/
+		Coef(long value);
+		
+		/** Constructor from GMP integer.
+
+			@param value mpz_class
+		*/
+		Coef(const mpz_class& value);
+		
+		/** Copy constructor.
+
+			@param old Coef to copy
+		*/
+		Coef(const Coef& old);
+		
+		/** Assignment operator.
+
+			@param old Coef to copy
+		*/
+		Coef& operator=(const Coef& old);
+		
+		/** Move constructor. old is left with value 0.
+
+			@param old Coef to move from
+		*/
+		Coef(Coef&& old);
+		
+		/** Move assignment operator. old is left with value 0 or the previous value of this.
+
+			@param old Coef to move from
+		*/
+		Coef& operator=(Coef&& old);
+		
+		/** Destructor. */
+		~Coef();
+		
+		//*********************** Getters  ******************************************************//
+		
+		/** Return value as GMP integer. Fixed-width values are returned in the range [0, 2^128).
+
+			@return mpz_class
+		*/
+		mpz_class get_mpz() const;
+		
+		/** Return decimal string of the value.
+
+			@return std::string
+		*/
+		std::string get_str() const;
+		
+		/** Append the decimal string of the value to out.
+
+			@param out std::string
+		*/
+		void appendStr(std::string& out) const;
+		
+		/** Return whether the value is 0.
+
+			@return bool
+		*/
+		bool isZero() const;
+		
+		/** Return sign of the value (-1, 0 or 1). Fixed-width values are never negative.
+
+			@return int
+		*/
+		int sign() const;
+		
+		/** Return whether the value is 0 modulo 2^bits. Fixed-width values can only be tested for bits <= 128.
+
+			@param bits int
+			@return bool
+		*/
+		bool isZeroModPow2(int bits) const;
+		
+		/** Return the number of bits of the absolute value, 0 for the value 0.
+
+			@return int
+		*/
+		int bitSize() const;
+		
+		/** Return whether the coefficient uses the fixed-width representation.
+
+			@return bool
+		*/
+		bool isFixedWidth() const { return this->kind == WIDE; }
+		
+		/** Return whether the coefficient is stored as 64 bit integer.
+
+			@return bool
+		*/
+		bool isSmall() const { return this->kind == SMALL; }
+		
+		//*********************** Arithmetic  ******************************************************//
+		
+		/** Add other to this coefficient. If one operand is fixed-width, the result is fixed-width.
+
+			@param other Coef
+		*/
+		void add(const Coef& other);
+		
+		/** Set this coefficient to the product of a and b. If one operand is fixed-width, the result is fixed-width.
+
+			@param a Coef
+			@param b Coef
+		*/
+		void mul(const Coef& a, const Coef& b);
+		
+		/** Negate this coefficient. */
+		void neg();
+		
+		/** Reduce the coefficient modulo modNum into the range [0, modNum).
+
+			@param modNum mpz_class
+		*/
+		void mod(const mpz_class& modNum);
+		
+		/** Reduce the coefficient modulo modNum into the range [0, modNum) and store the quotient (after - before) / modNum.
+			The quotient is 0 iff the coefficient was already reduced.
+
+			@param modNum mpz_class
+			@param quotient Coef
+		*/
+		void modWithQuotient(const mpz_class& modNum, Coef& quotient);
+		
+		//*********************** Fixed-width helpers  ******************************************************//
+		
+		/** Switch to fixed-width representation, keeping the value modulo 2^128. */
+		void toFixedWidth();
+		
+		/** Switch to integer representation (SMALL or BIG). Fixed-width values become the non-negative integer they represent. */
+		void toInteger();
+		
+		/** Reduce the coefficient modulo 2^bits into the range [0, 2^bits), bits >= 1. Fixed-width coefficients are already kept
+			modulo 2^128, so they are only changed for bits < 128.
+
+			@param bits int
+		*/
+		void truncate(int bits);
+		
+		/** Return the number of bits k if modNum is 2^k with 1 <= k <= 128, otherwise 0.
+
+			@param modNum mpz_class
+			@return int
+		*/
+		static int fixedWidthBits(const mpz_class& modNum);
+		
+		/** Print coefficient to standard output.
+
+			@param stdout std::ostream
+			@param obj Coef
+			@return std::ostream
+		*/
+		friend std::ostream& operator<<(std::ostream& stdout, const Coef& obj);
+	
+	private:
+		// Representation of the value.
+		enum Kind : unsigned char { SMALL, BIG, WIDE };
+		
+		/** Set value to a 64 bit integer, releasing GMP memory if needed.
+
+			@param value int64_t
+		*/
+		void setSmall(int64_t value);
+		
+		/** Take over the value of the GMP integer value (which is left in an undefined state) and demote it if it fits into 64 bits.
+
+			@param value mpz_ptr
+		*/
+		void setBig(mpz_ptr value);
+		
+		/** Return the value as GMP integer, either the own GMP integer or tmp, which is set to the value.
+			tmp has to be initialized by the caller.
+
+			@param tmp mpz_ptr
+			@return mpz_srcptr
+		*/
+		mpz_srcptr asMpz(mpz_ptr tmp) const;
+		
+		/** Take over the value of old without copying GMP limbs. this must not own GMP memory. old is left with value 0.
+
+			@param old Coef
+		*/
+		void takeOver(Coef& old);
+		
+		/** Write the value modulo 2^128 into two 64 bit limbs (least significant first).
+
+			@param limbs uint64_t[2]
+		*/
+		void getLimbs(uint64_t limbs[2]) const;
+		
+		/** Set fixed-width value from two 64 bit limbs (least significant first).
+
+			@param limbs uint64_t[2]
+		*/
+		void setLimbs(const uint64_t limbs[2]);
+		
+		// Either the 64 bit value, an initialized GMP integer or the two limbs of the fixed-width value.
+		union {
+			int64_t small;
+			__mpz_struct big;
+			uint64_t wide[2];
+		};
+		
+		// Which member of the union is used.
+		Kind kind;
+};
+
+#endif /* COEF_H_ */
@@ -84,8 +84,9 @@ int main(int argc, char ** argv) {
   std::cout << "Result4:" << spec4 << std::endl;
   
   // After all steps have been finished, the proof has to be generated with this function.
-  // It is important to use the same file names as above when proof generation was started.
-  writePolysIntoPACProof("example.polys", "example.proof");
+  // It writes the proof into the files given when proof generation was started. Every polynomial keeps its own
+  // proof state, so several polynomials can generate proofs at the same time.
+  spec4.finishProofGeneration();
   
   return 0;
 }
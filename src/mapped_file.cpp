@@ -0,0 +1,74 @@
+/*------------------------------------------------------------------------*/
+/*! \file mapped_file.cpp
+    \brief contains a read-only view of a whole file, memory mapped if
+    possible.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include <fstream>
+#include <iterator>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped_file.h"
+
+//***************************************************************************************
+MappedFile::MappedFile(const std::string& filename) {
+	this->filename = filename;
+	this->data = NULL;
+	this->length = 0;
+	this->mapped = false;
+	this->opened = false;
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) return;
+	struct stat info;
+	if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+		void* pages = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (pages != MAP_FAILED) {
+			madvise(pages, info.st_size, MADV_SEQUENTIAL);  // Files are read front to back once.
+			this->data = static_cast<const char*>(pages);
+			this->length = info.st_size;
+			this->mapped = true;
+		}
+	}
+	close(fd);
+	if (!this->mapped) {  // Not mappable, read it into memory.
+		std::ifstream infile(filename, std::ios::binary);
+		if (!infile.is_open()) return;
+		this->buffer.assign(std::istreambuf_iterator<char>(infile), std::istreambuf_iterator<char>());
+		this->data = this->buffer.data();
+		this->length = this->buffer.size();
+	}
+	this->opened = true;
+}
+
+//***************************************************************************************
+MappedFile::~MappedFile() {
+	if (this->mapped) munmap(const_cast<char*>(this->data), this->length);
+}
+
+//***************************************************************************************
+bool MappedFile::isOpen() const {
+	return this->opened;
+}
+
+//***************************************************************************************
+const std::string& MappedFile::getFilename() const {
+	return this->filename;
+}
+
+//***************************************************************************************
+const char* MappedFile::getData() const {
+	return this->data;
+}
+
+//***************************************************************************************
+size_t MappedFile::getLength() const {
+	return this->length;
+}
@@ -0,0 +1,75 @@
+/*------------------------------------------------------------------------*/
+/*! \file mapped_file.h
+    \brief contains a read-only view of a whole file, memory mapped if
+    possible.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+// std includes.
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+// Contents of a file as one block of memory. Regular files are mapped, everything else (e.g. pipes) is read into a buffer.
+class MappedFile {
+
+	public:
+		//*********************** Constructors  ******************************************************//
+
+		/** Constructor. Maps the file or reads it into memory.
+
+			@param filename std::string
+		*/
+		MappedFile(const std::string& filename);
+
+		/** Destructor. Unmaps the file. */
+		virtual ~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		//*********************** Getters  ******************************************************//
+
+		/** Return whether the file could be opened.
+
+			@return bool
+		*/
+		bool isOpen() const;
+
+		/** Get the name of the file.
+
+			@return std::string
+		*/
+		const std::string& getFilename() const;
+
+		/** Get the first character of the file.
+
+			@return const char*
+		*/
+		const char* getData() const;
+
+		/** Get the length of the file in bytes.
+
+			@return size_t
+		*/
+		size_t getLength() const;
+
+	private:
+		// Name of the file.
+		std::string filename;
+
+		// Contents of the file, either mapped or read into buffer.
+		const char* data;
+		size_t length;
+		bool mapped;
+		bool opened;
+		std::vector<char> buffer;
+};
+
+#endif /* MAPPED_FILE_H_ */
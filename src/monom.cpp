@@ -9,23 +9,52 @@
 
 #include "monom.h"
 
+//***************************************************************************************
+void Monom::allocate(int size) {
+	this->externalStorage = false;
+	this->dirty = false;
+	if (size <= MONOM_INLINE_SIZE) {
+		this->vars = this->inlineVars;
+		this->ptrs = this->inlinePtrs;
+	} else {  // Long monomial, spill to the heap.
+		this->vars = new int[size];
+		this->ptrs = new MyList::ListElement*[size];
+	}
+}
+
+//***************************************************************************************
+void Monom::release() {
+	if (!this->isInline()) {
+		if (!this->externalStorage) {
+			delete[] this->vars;
+			delete[] this->ptrs;
+		}
+		this->externalStorage = false;
+		this->vars = this->inlineVars;
+		this->ptrs = this->inlinePtrs;
+	}
+}
+
 //***************************************************************************************
 Monom::Monom(){  // Empty constructor
-	this->vars = 0;
-	this->ptrs = 0;
+	this->vars = this->inlineVars;
+	this->ptrs = this->inlinePtrs;
+	this->externalStorage = false;
+	this->dirty = false;
 	this->size = 0;
 	this->sum = 0;
+	this->hashKey = 0;
 	this->factor = 0;
 }
 
 //***************************************************************************************
 Monom::Monom(const Monom& old){  // Copy constructor
-	this->vars = new int[old.size];
-	this->ptrs = new MyList::ListElement*[old.size];
+	this->allocate(old.size);
 	std::memcpy(this->vars, old.vars, old.size * sizeof(varIndex));
 	std::memcpy(this->ptrs, old.ptrs, old.size * sizeof(MyList::ListElement*));
 	this->size = old.size;
 	this->sum = old.sum;
+	this->hashKey = old.hashKey;
 	this->factor = old.factor;
 }
 
@@ -34,41 +63,79 @@ Monom& Monom::operator= (const Monom &old)  // Assignment operator.
 { 
    	// Check for self assignment 
    	if(this != &old) {
-   		delete[] this->vars;
-		delete[] this->ptrs;
-		this->vars = new int[old.size];
-		this->ptrs = new MyList::ListElement*[old.size];
+   		if (this->isInline() || this->externalStorage || this->size != old.size) {  // Own heap arrays of same size can be reused.
+   			this->release();
+			this->allocate(old.size);
+		}
 		std::memcpy(this->vars, old.vars, old.size * sizeof(varIndex));
 		std::memcpy(this->ptrs, old.ptrs, old.size * sizeof(MyList::ListElement*));
 		this->size = old.size;
 		this->sum = old.sum;
+		this->hashKey = old.hashKey;
 		this->factor = old.factor;
   	}
    	return *this; 
 } 
 
+//***************************************************************************************
+Monom::Monom(Monom&& old) {  // Move constructor
+	this->takeOver(old);
+}
+
+//***************************************************************************************
+Monom& Monom::operator= (Monom&& old) {  // Move assignment operator.
+	if (this != &old) {
+		this->release();
+		this->takeOver(old);
+	}
+	return *this;
+}
+
+//***************************************************************************************
+void Monom::takeOver(Monom& old) {
+	if (old.isInline() || old.externalStorage) {  // Arrays cannot be handed over, copy them.
+		this->allocate(old.size);
+		std::memcpy(this->vars, old.vars, old.size * sizeof(varIndex));
+		std::memcpy(this->ptrs, old.ptrs, old.size * sizeof(MyList::ListElement*));
+	} else {
+		this->vars = old.vars;
+		this->ptrs = old.ptrs;
+		this->externalStorage = false;
+		this->dirty = false;
+		old.vars = old.inlineVars;
+		old.ptrs = old.inlinePtrs;
+	}
+	this->size = old.size;
+	this->sum = old.sum;
+	this->hashKey = old.hashKey;
+	this->factor = std::move(old.factor);
+	if (!old.externalStorage) {  // External arrays are released by their owner, which may need their size.
+		old.size = 0;
+		old.sum = 0;
+		old.hashKey = 0;
+	}
+}
+
 //***************************************************************************************
 Monom::Monom(varIndex index) {
-	this->vars = new int[1];
-	this->ptrs = new MyList::ListElement*[1];
+	this->allocate(1);
 	this->vars[0] = index;
 	this->size = 1;
 	this->sum = index;
+	this->hashKey = varKey(index);
 	this->factor = 1;
 }
 
 //***************************************************************************************
 Monom::Monom(varIndex index1, varIndex index2) {
+	this->allocate(2);
 	// Assure no duplicates of variables.
 	if (index1 == index2) {
-		this->vars = new int[1];
-		this->ptrs = new MyList::ListElement*[1];
 		this->vars[0] = index1;
 		this->size = 1;
 		this->sum = index1;
+		this->hashKey = varKey(index1);
 	} else {
-		this->vars = new int[2];
-		this->ptrs = new MyList::ListElement*[2]; 
 		// Already sort variables in increasing way.
 		if (index1 < index2) {
 			this->vars[0] = index1;
@@ -79,6 +146,7 @@ Monom::Monom(varIndex index1, varIndex index2) {
 		}
 		this->size = 2;
 		this->sum = index1 + index2;
+		this->hashKey = varKey(index1) + varKey(index2);
 	}
 	this->factor = 1;
 }
@@ -91,35 +159,53 @@ Monom::Monom(varIndex myints[], int size) {
 	ptr = std::unique(myints, myints + size);  // Remove duplicates.
 	int newSize = std::distance(myints, ptr);  // Calculate new size of array after removing duplicates.
 	int calcSum = 0;
+	uint64_t calcHash = 0;
 	
-	this->vars = new int[newSize];
-	this->ptrs = new MyList::ListElement*[newSize];
+	this->allocate(newSize);
 	for (int i=0; i < newSize; i++) {
 		this->vars[i] = myints[i];
-		calcSum += myints[i];  // Calculate sum simultaneously.
+		calcSum += myints[i];  // Calculate sum and hash simultaneously.
+		calcHash += varKey(myints[i]);
 	}
 	this->size = newSize;
 	this->sum = calcSum;
+	this->hashKey = calcHash;
 	this->factor = 1;
 }
 
 //***************************************************************************************
 Monom::Monom(varIndex myints[], int size, int sum, mpz_class factor) {
 	// Use this function only for already sorted and duplicate free myints.
-	this->vars = new int[size];
-	this->ptrs = new MyList::ListElement*[size];
+	this->allocate(size);
+	uint64_t calcHash = 0;
+	for (int i=0; i < size; i++) {
+		this->vars[i] = myints[i];
+		calcHash += varKey(myints[i]);
+	}
+	this->size = size;
+	this->sum =  sum;
+	this->hashKey = calcHash;
+	this->factor = factor;
+}
+
+//***************************************************************************************
+Monom::Monom(varIndex myints[], int size, int sum, const Coef& factor) {
+	// Use this function only for already sorted and duplicate free myints.
+	this->allocate(size);
+	uint64_t calcHash = 0;
 	for (int i=0; i < size; i++) {
 		this->vars[i] = myints[i];
+		calcHash += varKey(myints[i]);
 	}
 	this->size = size;
 	this->sum =  sum;
+	this->hashKey = calcHash;
 	this->factor = factor;
 }
 
 //***************************************************************************************
 Monom::~Monom() {
-	delete[] this->vars;
-	delete[] this->ptrs;
+	this->release();
 }
 
 //***************************************************************************************
@@ -134,7 +220,7 @@ MyList::ListElement** Monom::getPtrs() const{
 
 //***************************************************************************************
 void Monom::setPtrs(MyList::ListElement** ptrs) {
-	this->ptrs = ptrs;
+	std::memcpy(this->ptrs, ptrs, this->size * sizeof(MyList::ListElement*));
 }
 
 //***************************************************************************************
@@ -149,7 +235,7 @@ void Monom::setSize(int size) {
 
 //***************************************************************************************
 mpz_class Monom::getFactor() const {
-	return this->factor;
+	return this->factor.get_mpz();
 }
 
 //***************************************************************************************
@@ -181,6 +267,15 @@ int Monom::calculateSum() const{
 	return result;
 }
 
+//***************************************************************************************
+uint64_t Monom::calculateHash() const {
+	uint64_t result = 0;
+	for (int i = 0; i < this->size; i++) {
+		result += varKey(this->vars[i]);
+	}
+	return result;
+}
+
 //***************************************************************************************
 bool Monom::operator>(const Monom &m1) const {
 	return (m1 < *this);
@@ -198,8 +293,8 @@ bool Monom::operator<(const Monom &m1) const {
 
 //***************************************************************************************
 bool Monom::operator==(const Monom &m1) const {
+	if (this->hashKey != m1.hashKey) return false;
 	if (this->getSize() != m1.getSize()) return false;
-	if (this->getSum() != m1.getSum()) return false;	
 	for (int i=0; i < this->getSize(); i++) {
 		if (!(this->vars[i] == m1.vars[i])) return false;
 	}
@@ -216,7 +311,7 @@ std::ostream& operator<<(std::ostream& stdout, const Monom& obj) {
 	std::string s;
 	int elem = 0;
 	int elemCoef = 0;
-	std::string start = "[" + obj.getFactor().get_str() + "*" , end = "]", delim = "*";
+	std::string start = "[" + obj.factor.get_str() + "*" , end = "]", delim = "*";
     	if (obj.getSize() > 0){
         	s += start;
         	for (int i = 0; i < obj.getSize(); i++){
@@ -246,7 +341,7 @@ const std::string Monom::to_string_reverse() const {
     	std::string s;
 	int elem = 0;
 	int elemCoef = 0;
-	std::string start = "[" + this->getFactor().get_str() + "*" , end = "]", delim = "*";
+	std::string start = "[" + this->factor.get_str() + "*" , end = "]", delim = "*";
     	if (this->getSize() > 0){
         	s += start;
         	for (int i = this->getSize() - 1; i >= 0; --i){
@@ -264,15 +359,33 @@ const std::string Monom::to_string_reverse() const {
 }
 
 //***************************************************************************************
-Monom Monom::merge(varIndex replace, Monom mon) {
+void Monom::appendPAC(std::string& out) const {
+	this->factor.appendStr(out);
+	char digits[12];
+	for (int i = 0; i < this->size; i++) {
+		out.append("*x");
+		int count = 0;
+		unsigned value = this->vars[i];
+		do {
+			digits[count++] = '0' + value % 10;
+			value /= 10;
+		} while (value != 0);
+		while (count > 0) out.push_back(digits[--count]);
+	}
+}
+
+//***************************************************************************************
+Monom Monom::merge(varIndex replace, const Monom& mon) const {
 	// Use this function only if you are sure that "this object" includes "replace" variable. 
 	int newSize = this->size + mon.getSize() - 1; // Calculate new monom length. It will be one shorter since "replace" index will be replaced.
 	if (newSize < 0) { // Merge empty monoms.
 		Monom empty;
-		empty.setFactor(this->factor * mon.getFactor());
+		empty.factor.mul(this->factor, mon.factor);
 		return empty;
 	}
-	varIndex* result = new int[newSize]; // Create new array for saving monom temporary.
+	Monom nMon;  // Resulting monomial, variables are written directly into its storage.
+	nMon.allocate(newSize);
+	varIndex* result = nMon.vars;
 	varIndex one = -1; // Used for variable indexes.
 	varIndex two = -1;
 	int pos1 = 0; // Used for current position in monom. 
@@ -283,6 +396,7 @@ Monom Monom::merge(varIndex replace, Monom mon) {
 	bool oneEmpty = false;  //Notice if one is the empty monom(e.g. just a factor).
 	bool twoEmpty = false; 
 	int sum = 0;  // While merging, calculate sum simultaneously.
+	uint64_t hashKey = this->hashKey - varKey(replace);  // Hash is updated incrementally: only variables new from mon are added.
 	if (this->size == 0) { oneEmpty = true; }
 	if (mon.getSize() == 0) { twoEmpty = true; }
 	for(int i = 0; i < newSize; i++) {
@@ -343,6 +457,7 @@ Monom Monom::merge(varIndex replace, Monom mon) {
 				} else {
 					result[i - equal] = two; 
 					sum += two;  // Calculate sum simultaneously.
+					hashKey += varKey(two);
 					pos2++;
 					if (pos2 == mon.getSize()) { 
 			 			twoEnd = true;
@@ -359,6 +474,7 @@ Monom Monom::merge(varIndex replace, Monom mon) {
 				 	i++;
 				 	pos2++;
 				} else { 
+					hashKey += varKey(two);
 					pos2++;
 				}
 			} else if (twoEnd) {
@@ -372,23 +488,26 @@ Monom Monom::merge(varIndex replace, Monom mon) {
 			}
 		}			
 	}
-	Monom nMon(result, newSize - equal, sum, this->factor * mon.getFactor());
-	// Free used memory.
-	delete[] result;
+	nMon.size = newSize - equal;
+	nMon.sum = sum;
+	nMon.hashKey = hashKey;
+	nMon.factor.mul(this->factor, mon.factor);
 	return nMon;
 }
 
 
 
 //***************************************************************************************
-Monom Monom::multiply(Monom mon1, Monom mon2) {
+Monom Monom::multiply(const Monom& mon1, const Monom& mon2) {
 	int newSize = mon1.getSize() + mon2.getSize(); // Calculate new monom length.
 	if (newSize < 0) { // Merge empty monoms.
 		Monom empty;
-		empty.setFactor(mon1.getFactor() * mon2.getFactor());
+		empty.factor.mul(mon1.factor, mon2.factor);
 		return empty;
 	}
-	varIndex* result = new int[newSize]; // Create new array for saving monom temporary.
+	Monom nMon;  // Resulting monomial, variables are written directly into its storage.
+	nMon.allocate(newSize);
+	varIndex* result = nMon.vars;
 	varIndex one = -1; // Used for variable indexes.
 	varIndex two = -1;
 	int pos1 = 0; // Used for current position in monom. 
@@ -399,6 +518,7 @@ Monom Monom::multiply(Monom mon1, Monom mon2) {
 	bool oneEmpty = false;  //Notice if one is the empty monom (e.g. just a factor).
 	bool twoEmpty = false; 
 	int sum = 0;  // While merging, calculate sum simultaneously.
+	uint64_t hashKey = mon1.hashKey;  // Hash is updated incrementally: only variables new from mon2 are added.
 	if (mon1.getSize() == 0) {oneEmpty = true;}
 	if (mon2.getSize() == 0) {twoEmpty = true;}
 	for(int i = 0; i < newSize; i++) {
@@ -442,6 +562,7 @@ Monom Monom::multiply(Monom mon1, Monom mon2) {
 				} else {
 					result[i - equal] = two; 
 					sum += two;  // Calculate sum simultaneously.
+					hashKey += varKey(two);
 					pos2++;
 					if (pos2 == mon2.getSize()) { 
 			 			twoEnd = true;
@@ -458,6 +579,7 @@ Monom Monom::multiply(Monom mon1, Monom mon2) {
 				 	i++;
 				 	pos2++;
 				} else { 
+					hashKey += varKey(two);
 					pos2++;
 				}
 			} else if (twoEnd) {
@@ -471,8 +593,9 @@ Monom Monom::multiply(Monom mon1, Monom mon2) {
 			}
 		}		
 	}
-	Monom nMon(result, newSize - equal, sum, mon1.factor * mon2.getFactor());
-	// Free used memory.
-	delete[] result;
+	nMon.size = newSize - equal;
+	nMon.sum = sum;
+	nMon.hashKey = hashKey;
+	nMon.factor.mul(mon1.factor, mon2.factor);
 	return nMon;
 }
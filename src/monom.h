@@ -10,14 +10,17 @@
 // std includes.
 #include <string>
 #include <stdlib.h>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <sstream>
+#include <utility>
 
 // Gnu multiprecision library.
 #include <gmpxx.h>
 
 // Local includes.
+#include "coef.h"
 #include "mylist.h"
 
 #ifndef MONOM_H_
@@ -26,6 +29,12 @@
 // Integers used for variable indices. 
 typedef int varIndex;
 
+// Monomials with at most this many variables keep their variable and back pointer arrays inline.
+// Longer monomials spill both arrays to the heap.
+#ifndef MONOM_INLINE_SIZE
+#define MONOM_INLINE_SIZE 8
+#endif
+
 // Class to represent a monomial.
 class Monom {
 
@@ -48,6 +57,18 @@ class Monom {
 		*/
 		Monom& operator = (const Monom& old);
 		
+		/** Move constructor. Takes over the heap arrays of long monomials, old is left as empty monomial.
+
+			@param old Monom to move from
+		*/
+		Monom(Monom&& old);
+		
+		/** Move assignment operator. Takes over the heap arrays of long monomials, old is left as empty monomial.
+
+			@param old Monom to move from
+		*/
+		Monom& operator = (Monom&& old);
+		
 		/** Constructor for monomial with one variable and coefficient 1. 
 
 			@param index varIndex
@@ -77,6 +98,15 @@ class Monom {
 		*/
 		Monom(varIndex myints[], int size, int sum, mpz_class factor);
 		
+		/** Constructor used internally, like the one above but taking the coefficient as Coef.
+
+			@param myints[] varIndex
+			@param size integer size of array argument
+			@param sum integer sum of all array elements
+			@param factor Coef coefficient of monomial
+		*/
+		Monom(varIndex myints[], int size, int sum, const Coef& factor);
+		
 		/** Destructor. */
 		virtual ~Monom();
 		
@@ -94,7 +124,7 @@ class Monom {
 		*/
 		MyList::ListElement** getPtrs() const;
 		
-		/** Setter for MyList::ListElement array. 
+		/** Setter for MyList::ListElement array. Copies getSize() entries into the monomials own storage.
 
 			@param ptrs MyList::ListElement**
 		*/
@@ -151,7 +181,7 @@ class Monom {
 			@param replace varIndex to be replaced
 			@return mon Monom newly created
 		*/
-		Monom merge(varIndex replace, Monom mon);
+		Monom merge(varIndex replace, const Monom& mon) const;
 		
 		//*********************** Other helper functions.  ******************************************************//
 		
@@ -161,6 +191,32 @@ class Monom {
 		*/
 		int calculateSum() const;
 		
+		/** Getter for the 64 bit hash of the variables of the monomial. The coefficient is not included.
+			The hash is the sum of varKey() over all variables and is maintained incrementally.
+
+			@return uint64_t
+		*/
+		uint64_t hash() const { return this->hashKey; }
+		
+		/** Calculate hash by adding up the keys of all variables.
+
+			@return uint64_t
+		*/
+		uint64_t calculateHash() const;
+		
+		/** Pseudo random 64 bit key of a variable (splitmix64 finalizer). Monomial hashes are sums of these keys,
+			so adding or removing a variable updates the hash in constant time.
+
+			@param v varIndex
+			@return uint64_t
+		*/
+		static uint64_t varKey(varIndex v) {
+			uint64_t z = (uint64_t)(uint32_t)v * 0x9e3779b97f4a7c15ULL;
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			return z ^ (z >> 31);
+		}
+		
 		/** Return whether variable v is contained in the monomial.
 
 			@param v varIndex
@@ -174,7 +230,7 @@ class Monom {
 			@param mon2 Monom
 			@return Monom
 		*/
-		static Monom multiply(Monom mon1, Monom mon2);
+		static Monom multiply(const Monom& mon1, const Monom& mon2);
 		
 		/** Print a monomial to standard output.
 
@@ -195,21 +251,64 @@ class Monom {
 			@return std::string
 		*/
 		const std::string to_string_reverse() const;
+		
+		/** Append the monomial in PAC syntax to out, e.g. "-3*x1*x2" or "5" for a constant.
+
+			@param out std::string
+		*/
+		void appendPAC(std::string& out) const;
 	
 	private:
-		// Array for all variables of monomial. 
+		/** Point vars and ptrs to storage for size variables. Uses the inline buffers if possible, otherwise heap arrays.
+			Previous storage has to be released before.
+
+			@param size int
+		*/
+		void allocate(int size);
+		
+		/** Free heap storage of vars and ptrs if the monomial spilled to the heap. Storage owned by a PolyArena is not freed. */
+		void release();
+		
+		/** Return whether vars and ptrs point to the inline buffers.
+
+			@return bool
+		*/
+		bool isInline() const { return this->vars == this->inlineVars; }
+		
+		/** Take over variables, back pointers and coefficient of old. Heap arrays are stolen, inline and external
+			arrays are copied. this has to be released before. old is left as empty monomial
+			unless its arrays are external.
+
+			@param old Monom
+		*/
+		void takeOver(Monom& old);
+		
+		// Array for all variables of monomial. Points either to inlineVars or to a heap array for long monomials.
 		varIndex *vars;
 		
 		// Helper variables to track size (# of variables) and sum (sum of indices) of monomial.
 		int size;
 		int sum;
 		
-		// Coefficient of monomial. GMP library used because coefficients fastly exceed int64 range.
-		mutable mpz_class factor;
+		// Sum of varKey() of all variables. Strong filter for equality, sum alone collides heavily on large circuits.
+		uint64_t hashKey;
+		
+		// Coefficient of monomial. 64 bit integer promoted to GMP on overflow, fixed-width if the owning polynomial reduces modulo 2^k.
+		Coef factor;
 		
 		// Pointer back to ListElement entry, used for enabling constant deletion of elements from the list.
 		MyList::ListElement** ptrs;
-
+		
+		// True if vars and ptrs are not owned by the monomial: arrays of a long monomial handed over to the PolyArena 
+		// of the owning polynomial, or the scratch buffers of a substitution (see Polynom::substitute).
+		bool externalStorage;
+		
+		// True while the monomial is in the dirty set of its polynomial (see Polynom::setDirtyTracking). Not copied.
+		bool dirty;
+		
+		// Inline storage for short monomials, avoiding two heap allocations per monomial.
+		varIndex inlineVars[MONOM_INLINE_SIZE];
+		MyList::ListElement* inlinePtrs[MONOM_INLINE_SIZE];
 
 
 };
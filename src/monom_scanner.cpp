@@ -0,0 +1,116 @@
+/*------------------------------------------------------------------------*/
+/*! \file monom_scanner.cpp
+    \brief contains the scanner reading polynomials in text form
+    monomial by monomial.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include "monom_scanner.h"
+
+//***************************************************************************************
+MonomScanner::MonomScanner(const char* begin, const char* end) {
+	this->pos = begin;
+	this->end = end;
+	this->sum = 0;
+}
+
+//***************************************************************************************
+MonomScanner::MonomScanner(const std::string& line) {
+	this->pos = line.data();
+	this->end = line.data() + line.size();
+	this->sum = 0;
+}
+
+//***************************************************************************************
+MonomScanner::~MonomScanner() {
+}
+
+//***************************************************************************************
+bool MonomScanner::next() {
+	while (this->pos < this->end && (*this->pos == ' ' || *this->pos == '\r')) this->pos++;
+	if (this->pos == this->end) return false;
+	bool negative = false;
+	if (*this->pos == '+' || *this->pos == '-') {
+		negative = (*this->pos == '-');
+		this->pos++;
+	}
+	while (this->pos < this->end && *this->pos == ' ') this->pos++;
+	this->readCoef(negative);
+	this->vars.clear();
+	this->sum = 0;
+	// Variables up to the sign of the next monomial. Separators and the variable prefix x are skipped.
+	while (this->pos < this->end && *this->pos != '+' && *this->pos != '-') {
+		if (*this->pos < '0' || *this->pos > '9') {
+			this->pos++;
+			continue;
+		}
+		varIndex var = 0;
+		while (this->pos < this->end && *this->pos >= '0' && *this->pos <= '9') {
+			var = var * 10 + (*this->pos - '0');
+			this->pos++;
+		}
+		this->vars.push_back(var);
+		this->sum += var;
+	}
+	return true;
+}
+
+//***************************************************************************************
+void MonomScanner::readCoef(bool negative) {
+	const char* start = this->pos;
+	uint64_t value = 0;
+	bool overflow = false;
+	while (this->pos < this->end && *this->pos >= '0' && *this->pos <= '9') {
+		unsigned digit = *this->pos - '0';
+		if (value > (UINT64_MAX - digit) / 10) overflow = true;
+		else value = value * 10 + digit;
+		this->pos++;
+	}
+	if (this->pos == start) {  // No coefficient given.
+		this->coef = Coef(negative ? -1L : 1L);
+		return;
+	}
+	uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+	if (!overflow && value <= limit) {
+		this->coef = Coef(negative ? (long)(0 - value) : (long)value);
+		return;
+	}
+	this->digits.assign(negative ? "-" : "");
+	this->digits.append(start, this->pos);
+	mpz_set_str(this->big.get_mpz_t(), this->digits.c_str(), 10);
+	this->coef = Coef(this->big);
+}
+
+//***************************************************************************************
+const Coef& MonomScanner::getCoef() const {
+	return this->coef;
+}
+
+//***************************************************************************************
+varIndex* MonomScanner::getVars() {
+	return this->vars.data();
+}
+
+//***************************************************************************************
+int MonomScanner::getSize() const {
+	return this->vars.size();
+}
+
+//***************************************************************************************
+int MonomScanner::getSum() const {
+	return this->sum;
+}
+
+//***************************************************************************************
+varIndex MonomScanner::getLastVar() const {
+	return this->vars.empty() ? 0 : this->vars.back();
+}
+
+//***************************************************************************************
+Monom MonomScanner::toMonom(bool sort) {
+	if (sort) std::sort(this->vars.begin(), this->vars.end());
+	return Monom(this->vars.data(), this->vars.size(), this->sum, this->coef);
+}
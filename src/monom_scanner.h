@@ -0,0 +1,114 @@
+/*------------------------------------------------------------------------*/
+/*! \file monom_scanner.h
+    \brief contains the scanner reading polynomials in text form
+    monomial by monomial.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#ifndef MONOM_SCANNER_H_
+#define MONOM_SCANNER_H_
+
+// std includes.
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include <gmpxx.h>
+
+// Local includes.
+#include "coef.h"
+#include "monom.h"
+
+// Single pass scanner for polynomials in the text format of the step files and PAC proofs, e.g. "+3*x1*x2-1*x3+1".
+// Coefficients fitting into 64 bit are read without GMP, the variables of the current monomial are kept in a reusable buffer.
+class MonomScanner {
+
+	public:
+		//*********************** Constructors  ******************************************************//
+
+		/** Constructor for scanning the characters [begin, end).
+
+			@param begin const char*
+			@param end const char*
+		*/
+		MonomScanner(const char* begin, const char* end);
+
+		/** Constructor for scanning a string. The string has to outlive the scanner.
+
+			@param line std::string
+		*/
+		MonomScanner(const std::string& line);
+
+		/** Destructor. */
+		virtual ~MonomScanner();
+
+		//*********************** Scanning  ******************************************************//
+
+		/** Read the next monomial. A missing coefficient is read as 1.
+
+			@return bool false if the end of the input is reached
+		*/
+		bool next();
+
+		/** Get the coefficient of the current monomial.
+
+			@return const Coef&
+		*/
+		const Coef& getCoef() const;
+
+		/** Get the variables of the current monomial in input order.
+
+			@return varIndex*
+		*/
+		varIndex* getVars();
+
+		/** Get the number of variables of the current monomial.
+
+			@return int
+		*/
+		int getSize() const;
+
+		/** Get the sum of the variable indices of the current monomial.
+
+			@return int
+		*/
+		int getSum() const;
+
+		/** Get the last variable of the current monomial, 0 if it has none.
+
+			@return varIndex
+		*/
+		varIndex getLastVar() const;
+
+		/** Create the current monomial. Sorts its variables first if sort is set, otherwise they have to be sorted already.
+
+			@param sort bool
+			@return Monom
+		*/
+		Monom toMonom(bool sort);
+
+	private:
+		/** Read an unsigned decimal number at the current position into the coefficient.
+
+			@param negative bool
+		*/
+		void readCoef(bool negative);
+
+		// Remaining input.
+		const char* pos;
+		const char* end;
+
+		// Current monomial.
+		Coef coef;
+		std::vector<varIndex> vars;
+		int sum;
+
+		// Buffers for coefficients exceeding 64 bit, reused for all monomials.
+		std::string digits;
+		mpz_class big;
+};
+
+#endif /* MONOM_SCANNER_H_ */
@@ -0,0 +1,125 @@
+/*------------------------------------------------------------------------*/
+/*! \file monom_table.cpp
+    \brief contains the open addressing hash table used as alternative
+    monomial container of polynomials.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include "monom_table.h"
+
+//***************************************************************************************
+MonomTable::MonomTable() {
+	Slot empty = {0, NULL};
+	this->slots.assign(16, empty);
+	this->mask = 15;
+	this->count = 0;
+}
+
+//***************************************************************************************
+MonomTable::~MonomTable() {
+}
+
+//***************************************************************************************
+Monom* MonomTable::find(const Monom& mon) const {
+	uint64_t hash = mon.hash();
+	for (size_t i = hash & this->mask; ; i = (i + 1) & this->mask) {
+		const Slot& slot = this->slots[i];
+		if (slot.data == NULL) return NULL;
+		if (slot.hash == hash && *slot.data == mon) return slot.data;
+	}
+}
+
+//***************************************************************************************
+void MonomTable::insert(Monom* mon) {
+	if (2 * (this->count + 1) > this->slots.size()) this->grow();  // Keep load factor at most 1/2.
+	uint64_t hash = mon->hash();
+	size_t i = hash & this->mask;
+	while (this->slots[i].data != NULL) {
+		i = (i + 1) & this->mask;
+	}
+	this->slots[i].hash = hash;
+	this->slots[i].data = mon;
+	this->count++;
+}
+
+//***************************************************************************************
+void MonomTable::erase(const Monom* mon) {
+	uint64_t hash = mon->hash();
+	size_t i = hash & this->mask;
+	while (this->slots[i].data != mon) {
+		if (this->slots[i].data == NULL) return;  // Not contained.
+		i = (i + 1) & this->mask;
+	}
+	// Backward shift deletion: move following entries of the probe sequence into the gap, so no tombstones are needed.
+	size_t j = i;
+	while (true) {
+		j = (j + 1) & this->mask;
+		if (this->slots[j].data == NULL) break;
+		size_t home = this->slots[j].hash & this->mask;
+		bool movable = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+		if (movable) {
+			this->slots[i] = this->slots[j];
+			i = j;
+		}
+	}
+	this->slots[i].data = NULL;
+	this->count--;
+	if (this->slots.size() > 16 && 8 * this->count < this->slots.size()) {  // Shrink to a load factor of about 1/4.
+		size_t capacity = 16;
+		while (capacity < 4 * this->count) capacity *= 2;
+		this->rehash(capacity);
+	}
+}
+
+//***************************************************************************************
+void MonomTable::clear() {
+	Slot empty = {0, NULL};
+	this->slots.assign(16, empty);
+	this->mask = 15;
+	this->count = 0;
+}
+
+//***************************************************************************************
+void MonomTable::swap(MonomTable& other) {
+	this->slots.swap(other.slots);
+	std::swap(this->mask, other.mask);
+	std::swap(this->count, other.count);
+}
+
+//***************************************************************************************
+void MonomTable::collect(std::vector<Monom*>& result) const {
+	result.reserve(result.size() + this->count);
+	for (size_t i = 0; i < this->slots.size(); i++) {
+		if (this->slots[i].data != NULL) result.push_back(this->slots[i].data);
+	}
+}
+
+//***************************************************************************************
+size_t MonomTable::size() const {
+	return this->count;
+}
+
+//***************************************************************************************
+void MonomTable::grow() {
+	this->rehash(2 * this->slots.size());
+}
+
+//***************************************************************************************
+void MonomTable::rehash(size_t capacity) {
+	std::vector<Slot> old;
+	old.swap(this->slots);
+	Slot empty = {0, NULL};
+	this->slots.assign(capacity, empty);
+	this->mask = this->slots.size() - 1;
+	for (size_t k = 0; k < old.size(); k++) {
+		if (old[k].data == NULL) continue;
+		size_t i = old[k].hash & this->mask;
+		while (this->slots[i].data != NULL) {
+			i = (i + 1) & this->mask;
+		}
+		this->slots[i] = old[k];
+	}
+}
@@ -0,0 +1,100 @@
+/*------------------------------------------------------------------------*/
+/*! \file monom_table.h
+    \brief contains the open addressing hash table used as alternative
+    monomial container of polynomials.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#ifndef MONOM_TABLE_H_
+#define MONOM_TABLE_H_
+
+// std includes.
+#include <stdlib.h>
+#include <cstdint>
+#include <vector>
+
+// Local includes.
+#include "monom.h"
+
+// Open addressing hash table (linear probing) of pointers to monomials, keyed by Monom::hash().
+// The table does not own the monomials, the polynomial allocates and frees them.
+class MonomTable {
+
+	public:
+		//*********************** Constructors  ******************************************************//
+		
+		/** Constructor. */
+		MonomTable();
+		
+		/** Destructor. */
+		virtual ~MonomTable();
+		
+		//*********************** Table operations  ******************************************************//
+		
+		/** Return pointer to the monomial with the same variables as mon, or NULL if there is none.
+
+			@param mon Monom
+			@return Monom*
+		*/
+		Monom* find(const Monom& mon) const;
+		
+		/** Insert monomial. A monomial with the same variables must not be contained in the table.
+
+			@param mon Monom*
+		*/
+		void insert(Monom* mon);
+		
+		/** Remove monomial from the table. The pointer has to be the one stored in the table.
+			The table shrinks once less than 1/8 of its slots are used, so scans after a peak stay cheap.
+
+			@param mon Monom*
+		*/
+		void erase(const Monom* mon);
+		
+		/** Remove all entries. */
+		void clear();
+		
+		/** Exchange contents with other.
+
+			@param other MonomTable
+		*/
+		void swap(MonomTable& other);
+		
+		/** Append pointers to all monomials in table order (unordered) to result.
+
+			@param result std::vector<Monom*>
+		*/
+		void collect(std::vector<Monom*>& result) const;
+		
+		/** Get number of monomials in the table.
+
+			@return size_t
+		*/
+		size_t size() const;
+	
+	private:
+		// Entry of the table. Caching the hash avoids touching the monomial while probing and rehashing.
+		struct Slot {
+			uint64_t hash;
+			Monom* data;  // NULL marks an empty slot.
+		};
+		
+		/** Double the capacity and reinsert all entries. */
+		void grow();
+		
+		/** Reinsert all entries into a table with the given number of slots.
+
+			@param capacity size_t power of two, at least twice the number of entries
+		*/
+		void rehash(size_t capacity);
+		
+		// Slots of the table, capacity is always a power of two.
+		std::vector<Slot> slots;
+		size_t mask;
+		size_t count;
+};
+
+#endif /* MONOM_TABLE_H_ */
@@ -16,15 +16,39 @@
 MyList::MyList(){
 	this->head = this->tail = NULL;
 	this->size = 0;
+	this->arena = NULL;
 }
 
 MyList::~MyList(){
-	this->deleteList();
+	if (this->arena == NULL) this->deleteList();
+}
+
+void MyList::setArena(PolyArena* arena) {
+	if (!this->isEmpty()) {
+		std::cout << "Cannot change arena of non-empty list." << std::endl;
+		return;
+	}
+	this->arena = arena;
+}
+
+MyList::ListElement* MyList::newElement(Monom* data, PolyArena* pool) {
+	if (pool == NULL) return new ListElement(data);
+	return new (pool->allocate(sizeof(ListElement))) ListElement(data);
+}
+
+void MyList::freeElement(ListElement* element, PolyArena* pool) {
+	if (pool == NULL) delete element;
+	else pool->deallocate(element, sizeof(ListElement));
 }
 
 // Add entry.
 MyList::ListElement* MyList::add(Monom* data){
-	ListElement* newElement = new ListElement(data);
+	return this->add(data, this->arena);
+}
+
+// Add entry taken from pool.
+MyList::ListElement* MyList::add(Monom* data, PolyArena* pool){
+	ListElement* newElement = this->newElement(data, pool);
 	if(this->isEmpty()) {  // List was empty.
         	this->head = this->tail = newElement;
     } else {  // List not empty. 
@@ -55,6 +79,10 @@ void MyList::show() {
 }
 
 void MyList::deleteElement(ListElement* element) {
+	this->deleteElement(element, this->arena);
+}
+
+void MyList::deleteElement(ListElement* element, PolyArena* pool) {
 	if(isEmpty()) return;
 	if(element == NULL) {
 		std::cout << "Trying to delete not existing element." << std::endl;
@@ -75,7 +103,7 @@ void MyList::deleteElement(ListElement* element) {
 		element->prev->next = element->next;
 		element->next->prev = element->prev;
 	}
-	delete element;
+	this->freeElement(element, pool);
 	this->size--;
 }
 
@@ -87,14 +115,14 @@ void MyList::deleteList() {
         	// Take second last element. 
 		ListElement* secondLast = this->tail->prev;
         	// Delete last element.
-        	delete this->tail;
+        	this->freeElement(this->tail, this->arena);
         	// Make second last element the last element.
         	secondLast->next = NULL;
         	this->tail = secondLast;
     	}
  	// At last delete list head.
- 	delete this->head;
- 	this->head = NULL;
+ 	this->freeElement(this->head, this->arena);
+ 	this->head = this->tail = NULL;
  	this->size = 0;
 }
 
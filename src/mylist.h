@@ -12,6 +12,9 @@
 #ifndef MYLIST_H_
 #define MYLIST_H_
 
+// Local includes.
+#include "arena.h"
+
 class Monom;
 
 class MyList {
@@ -45,6 +48,24 @@ class MyList {
 	ListElement* tail; 
 	int size;
 	
+	// Pool the list elements are taken from. If NULL, elements are allocated on the heap.
+	PolyArena* arena;
+	
+	/** Allocate and construct a new list element.
+
+		@param data Monom*
+		@param pool PolyArena* to take the element from, heap if NULL
+		@return Pointer to new element.
+	*/
+	ListElement* newElement(Monom* data, PolyArena* pool);
+	
+	/** Give a list element back to the pool or the heap.
+
+		@param element ListElement*
+		@param pool PolyArena* the element was taken from, heap if NULL
+	*/
+	void freeElement(ListElement* element, PolyArena* pool);
+	
 	public:	
 		// Iterator class for the list.
 		class Iterator
@@ -101,9 +122,15 @@ class MyList {
 		/** Constructor */
 		MyList();
 		
-		/** Destructor */
+		/** Destructor. Elements taken from an arena are not freed one by one, they are released together with the arena. */
 		virtual ~MyList();
 		
+		/** Take all future list elements from the given arena. Only allowed while the list is empty.
+
+			@param arena PolyArena*
+		*/
+		void setArena(PolyArena* arena);
+		
 		/** Add element to list.
 
 			@param data Monom*
@@ -112,6 +139,16 @@ class MyList {
 		*/
     	ListElement* add(Monom* data);
     	
+    	/** Add element to list, taking it from the given pool instead of the arena of the list.
+    		Used by sharded polynomials, whose shards own separate arenas.
+
+			@param data Monom*
+			@param pool PolyArena*
+
+			@return Pointer to new element.
+		*/
+    	ListElement* add(Monom* data, PolyArena* pool);
+    	
     	/** Check whether list is empty.
 
 			@return true if list is empty.
@@ -124,6 +161,13 @@ class MyList {
 		*/
 		void deleteElement(ListElement* element);
 		
+		/** Delete element from list and give it back to the pool it was taken from.
+
+			@param element ListElement* to delete.
+			@param pool PolyArena*
+		*/
+		void deleteElement(ListElement* element, PolyArena* pool);
+		
 		/** Delete list. */
 		void deleteList();
 		
@@ -12,143 +12,157 @@
 
 //****************************************************************************************/
 void init_spec(Polynom & spec, std::string filename) {
-  std::ifstream infile(filename);
-  if (!infile.is_open()) {
-    std::cout << "Error opening file " << filename << ". Make sure the filename is correct." << std::endl;
-  }
-  int lineNum = 0;
-  unsigned maxVarNum = 0;
-  std::string line;
-  mpz_class modCoef = 0;
-  while (std::getline(infile, line)) {
-    ++lineNum;
-    if (lineNum == 1) {
-      maxVarNum = std::stoi(line);
-      spec.resize(maxVarNum + 1);
-    } else if (lineNum == 2) {
-      modCoef = mpz_class(line);
-    } else if (lineNum == 3) {
-      // Create spec poly.
-      read_spec_poly(spec, line);
-      if (modCoef > 0) {
-        spec.setModReduction(true);
-        spec.setModReductionNumber(modCoef);
-        spec.modReducePoly(modCoef);
-      }
-    } else {
-     break;
-    }
+  if (BinaryStepFile::isBinary(filename)) {
+    BinaryStepFile file(filename);
+    init_spec(spec, file);
+    return;
+  }
+  StepFile file(filename);
+  init_spec(spec, file);
+}
+
+//****************************************************************************************/
+void init_spec(Polynom & spec, StepFile & file) {
+  if (!file.isOpen()) {
+    std::cout << "Error opening file " << file.getFilename() << ". Make sure the filename is correct." << std::endl;
+    return;
+  }
+  spec.resize(file.getMaxVarIndex() + 1);
+  // Create spec poly.
+  MonomScanner scanner = file.getSpec();
+  while (scanner.next()) {
+    spec.addMonom(scanner.toMonom(true));
+  }
+  const mpz_class& modCoef = file.getModulus();
+  if (modCoef > 0) {
+    spec.setModReduction(true);
+    spec.setModReductionNumber(modCoef);
+    spec.modReducePoly(modCoef);
+  }
+}
+
+//****************************************************************************************/
+void init_spec(Polynom & spec, BinaryStepFile & file) {
+  if (!file.isOpen()) {
+    std::cout << "Error opening file " << file.getFilename() << ". Make sure the filename is correct." << std::endl;
+    return;
+  }
+  spec.resize(file.getMaxVarIndex() + 1);
+  if (!file.readSpec(spec)) {
+    std::cout << "Error reading file " << file.getFilename() << ". The file is truncated or corrupted." << std::endl;
+  }
+  const mpz_class& modCoef = file.getModulus();
+  if (modCoef > 0) {
+    spec.setModReduction(true);
+    spec.setModReductionNumber(modCoef);
+    spec.modReducePoly(modCoef);
   }
-  infile.close();
 }
 
 //****************************************************************************************/
 void read_spec_poly(Polynom & spec, std::string line) {
-  std::vector<std::string> monomialStrings;
-  std::vector<std::string> variableStrings;
-  std::regex monDelimit("([+-]?[^+-]+)");
-  std::sregex_token_iterator it(line.begin(), line.end(), monDelimit);
-  std::sregex_token_iterator end;
-  for (; it != end; ++it) {
-    monomialStrings.push_back(it->str());
-  }
-  for (auto& elem: monomialStrings) {
-    variableStrings.clear();
-    std::regex varDelimit("[*]");
-    std::sregex_token_iterator it(elem.begin(), elem.end(), varDelimit, -1);
-    std::sregex_token_iterator end;
-    for (; it != end; ++it) {
-      variableStrings.push_back(it->str());
-    }
-    std::string currStr;
-    mpz_class tmpCoef;
-	int* tmpVars = new int[variableStrings.size() - 1];
-	int tmpSum = 0;
-	for (size_t i=0; i < variableStrings.size(); ++i) {
-		currStr = variableStrings[i];
-		if (i==0) {
-			size_t pos = 0;
-			if ((pos = currStr.find("+")) != std::string::npos) currStr.erase(pos, 1);
-			tmpCoef = mpz_class(currStr);
-		} else {
-			currStr.erase(currStr.find("x"), 1);
-			tmpVars[i-1] = std::stoi(currStr);
-			tmpSum += tmpVars[i-1];
-		}
-	}
-	std::sort(tmpVars, tmpVars + variableStrings.size() - 1);
-	Monom tmpMon(tmpVars, variableStrings.size() - 1, tmpSum, tmpCoef);
-	delete[] tmpVars;
-	spec.addMonom(tmpMon);
+  MonomScanner scanner(line);
+  while (scanner.next()) {
+    spec.addMonom(scanner.toMonom(true));
   }
+}
 
+//****************************************************************************************/
+void reduce_poly(Polynom & spec, std::string filename, ReductionStats * stats) {
+  if (BinaryStepFile::isBinary(filename)) {
+    BinaryStepFile file(filename);
+    reduce_poly(spec, file, stats);
+    return;
+  }
+  StepFile file(filename);
+  reduce_poly(spec, file, stats);
 }
 
 //****************************************************************************************/
-void reduce_poly(Polynom & spec, std::string filename) {
-  std::ifstream infile(filename);
-  if (!infile.is_open()) {
-    std::cout << "Error opening file " << filename << ". Make sure the filename is correct." << std::endl;
-  }
-  int lineNum = 0;
-  unsigned maxVarNum = 0;
-  std::string line;
+// Reduce spec by all steps delivered by nextStep, which is called on a background thread
+// so that parsing the upcoming steps overlaps with the reduction. On a single core the steps are parsed inline.
+template <typename NextStep>
+static void reduce_pipelined(Polynom & spec, NextStep nextStep, ReductionStats * stats) {
+  StepQueue queue;
+  std::thread parser;
+  bool pipelined = std::thread::hardware_concurrency() > 1;
+  if (pipelined) {
+    parser = std::thread([&queue, &nextStep]() {
+      varIndex leadingVar;
+      std::list<Monom> tail;
+      while (nextStep(leadingVar, tail)) {
+        queue.push(leadingVar, tail);
+      }
+      queue.close();
+    });
+  }
+  varIndex leadingVar;
+  std::list<Monom> tail;
+  int stepNum = 0;
   unsigned maxSize = 0;
-  while (std::getline(infile, line)) {
-    ++lineNum;
-    if (lineNum < 4) continue;
-    reduce_by_one_line(spec, line);
+  while (pipelined ? queue.pop(leadingVar, tail) : nextStep(leadingVar, tail)) {
+    ++stepNum;
+    spec.replaceVar(leadingVar, tail);
     if (maxSize < spec.size()) maxSize = spec.size();
-    std::cout << "Current step: " << lineNum - 3 << " with poly.size: " << spec.size() << std::endl;
+    std::cout << "Current step: " << stepNum << " with poly.size: " << spec.size() << std::endl;
   }
+  if (pipelined) parser.join();
+  spec.normalizeCoefs();  // The remainder is printed by the caller.
   std::cout << "Steps completed." << std::endl;
   std::cout << "Max. Size was " << maxSize << std::endl;
+  if (stats != NULL) {
+    stats->steps = stepNum;
+    stats->maxSize = maxSize;
+  }
 }
 
 //****************************************************************************************/
+void reduce_poly(Polynom & spec, StepFile & file, ReductionStats * stats) {
+  if (!file.isOpen()) {
+    std::cout << "Error opening file " << file.getFilename() << ". Make sure the filename is correct." << std::endl;
+  }
+  reduce_pipelined(spec, [&file](varIndex & leadingVar, std::list<Monom> & tail) {
+    const char* begin;
+    const char* end;
+    if (!file.nextStep(begin, end)) return false;
+    parse_step(begin, end, leadingVar, tail);
+    return true;
+  }, stats);
+}
+
+//****************************************************************************************/
+void reduce_poly(Polynom & spec, BinaryStepFile & file, ReductionStats * stats) {
+  if (!file.isOpen()) {
+    std::cout << "Error opening file " << file.getFilename() << ". Make sure the filename is correct." << std::endl;
+  }
+  reduce_pipelined(spec, [&file](varIndex & leadingVar, std::list<Monom> & tail) {
+    return file.nextStep(leadingVar, tail);
+  }, stats);
+  if (file.isCorrupted()) {
+    std::cout << "Error reading file " << file.getFilename() << ". The file is truncated or corrupted." << std::endl;
+  }
+}
 
+//****************************************************************************************/
 void reduce_by_one_line(Polynom & spec, std::string line) {
-  std::vector<std::string> monomialStrings;
-  std::vector<std::string> variableStrings;
-  std::regex monDelimit("([+-]?[^+-]+)");
-  std::sregex_token_iterator it(line.begin(), line.end(), monDelimit);
-  std::sregex_token_iterator end;
-  for (; it != end; ++it) {
-    monomialStrings.push_back(it->str());
-  }
-  int leadingVar = 0;
-  bool firstMonomial = true;
+  reduce_by_one_line(spec, line.data(), line.data() + line.size());
+}
+
+//****************************************************************************************/
+void reduce_by_one_line(Polynom & spec, const char* begin, const char* end) {
+  varIndex leadingVar;
   std::list<Monom> tail;
-  for (int j=0; j < monomialStrings.size(); ++j) {
-    variableStrings.clear();
+  parse_step(begin, end, leadingVar, tail);
+  spec.replaceVar(leadingVar, tail);
+}
 
-    std::regex varDelimit("[*]");
-    std::sregex_token_iterator it(monomialStrings[j].begin(), monomialStrings[j].end(), varDelimit, -1);
-    std::sregex_token_iterator end;
-    for (; it != end; ++it) {
-      variableStrings.push_back(it->str());
-    }
-    std::string currStr;
-    mpz_class tmpCoef;
-	int* tmpVars = new int[variableStrings.size() - 1];
-	int tmpSum = 0;
-	for (size_t i=0; i < variableStrings.size(); ++i) {
-		currStr = variableStrings[i];
-		if (i==0) {  // coefficient
-			size_t pos = 0;
-			if ((pos = currStr.find("+")) != std::string::npos) currStr.erase(pos, 1);
-			tmpCoef = mpz_class(currStr);
-		} else {  // variables
-			currStr.erase(currStr.find("x"), 1);
-			tmpVars[i-1] = std::stoi(currStr);
-			tmpSum += tmpVars[i-1];
-			if (firstMonomial) leadingVar = tmpVars[i-1];
-		}
-	}
-	Monom tmpMon(tmpVars, variableStrings.size() - 1, tmpSum, tmpCoef);
-	delete[] tmpVars;
-	if (!firstMonomial) tail.push_back(tmpMon);
-	firstMonomial = false;
+//****************************************************************************************/
+void parse_step(const char* begin, const char* end, varIndex & leadingVar, std::list<Monom> & tail) {
+  MonomScanner scanner(begin, end);
+  leadingVar = 0;
+  tail.clear();
+  if (scanner.next()) leadingVar = scanner.getLastVar();
+  while (scanner.next()) {
+    tail.push_back(scanner.toMonom(false));
   }
-  spec.replaceVar(leadingVar, tail);
 }
@@ -15,13 +15,25 @@
 #include <stdlib.h>
 
 #include <fstream>
-#include <regex>
+#include <thread>
 
 // Local includes.
+#include "binary_step_file.h"
+#include "monom_scanner.h"
 #include "polynom.h"
+#include "step_file.h"
+#include "step_queue.h"
 
 /**
-    Inititate gates and specification polynomial.
+    Counters of one reduce_poly call.
+*/
+struct ReductionStats {
+  size_t steps = 0;    // Number of substitution steps applied.
+  size_t maxSize = 0;  // Maximum number of monomials of spec after a step.
+};
+
+/**
+    Inititate gates and specification polynomial. Files in the binary step format are detected by their magic number.
 
     @param filename Name of the file with specification descriptions.
 
@@ -29,6 +41,24 @@
 */
 void init_spec(Polynom & spec, std::string filename);
 
+/**
+    Inititate specification polynomial from the header of an opened step file.
+
+    @param spec Polynomial for specification
+
+    @param file StepFile
+*/
+void init_spec(Polynom & spec, StepFile & file);
+
+/**
+    Inititate specification polynomial from the header of an opened binary step file.
+
+    @param spec Polynomial for specification
+
+    @param file BinaryStepFile
+*/
+void init_spec(Polynom & spec, BinaryStepFile & file);
+
 /**
     Creates specification polynomial from string line.
 
@@ -39,7 +69,7 @@ void init_spec(Polynom & spec, std::string filename);
 void read_spec_poly(Polynom & spec, std::string line);
 
 /**
-    Reduce spec by polynomials given in the file.
+    Reduce spec by polynomials given in the file. Files in the binary step format are detected by their magic number.
 
     @param spec specification Polynomial which will be reduced at the end
     
@@ -47,9 +77,34 @@ void read_spec_poly(Polynom & spec, std::string line);
     
     @param filename name of file containing the reduction polynomials
 
+    @param stats receives the number of steps and the maximum size of spec if not NULL
+
     @return reduced Polynomial
 */
-void reduce_poly(Polynom & spec, std::string filename);
+void reduce_poly(Polynom & spec, std::string filename, ReductionStats * stats = NULL);
+
+/**
+    Reduce spec by the remaining steps of an opened step file. The steps are read directly from the mapped file,
+    so init_spec and reduce_poly can share one StepFile. A background thread parses the upcoming steps while spec is reduced.
+
+    @param spec specification Polynomial which will be reduced at the end
+
+    @param file StepFile
+
+    @param stats receives the number of steps and the maximum size of spec if not NULL
+*/
+void reduce_poly(Polynom & spec, StepFile & file, ReductionStats * stats = NULL);
+
+/**
+    Reduce spec by the remaining steps of an opened binary step file. A background thread decodes the upcoming steps while spec is reduced.
+
+    @param spec specification Polynomial which will be reduced at the end
+
+    @param file BinaryStepFile
+
+    @param stats receives the number of steps and the maximum size of spec if not NULL
+*/
+void reduce_poly(Polynom & spec, BinaryStepFile & file, ReductionStats * stats = NULL);
 
 /**
     Convert given string line to a polynomial.
@@ -60,4 +115,28 @@ void reduce_poly(Polynom & spec, std::string filename);
 */
 void reduce_by_one_line(Polynom & spec, std::string line); 
 
+/**
+    Reduce spec by the step given by the characters [begin, end).
+
+    @param spec specification Polynomial to be reduced
+
+    @param begin const char*
+
+    @param end const char*
+*/
+void reduce_by_one_line(Polynom & spec, const char* begin, const char* end);
+
+/**
+    Parse the step given by the characters [begin, end) without applying it.
+
+    @param begin const char*
+
+    @param end const char*
+
+    @param leadingVar variable which is replaced
+
+    @param tail receives the replacing monomials
+*/
+void parse_step(const char* begin, const char* end, varIndex & leadingVar, std::list<Monom> & tail);
+
 #endif /* POLY_PARSER_H_ */
@@ -11,26 +11,35 @@
 #include "polynom.h"
 
 //***************************************************************************************
-Polynom::Polynom(){
-	this->refList = new MyList[1];
+// Order of monomial pointers by Monom::operator<, used for ordered output of the hash backend.
+static bool lessMonomPointer(const Monom* mon1, const Monom* mon2) {
+	return *mon1 < *mon2;
+}
+
+//***************************************************************************************
+Polynom::Polynom() : arena(new PolyArena()), polySet(std::less<Monom>(), ArenaAllocator<Monom>(arena.get())), setSnapshot(std::less<Monom>(), ArenaAllocator<Monom>(arena.get())) {
+	this->refList = this->newRefList(1);
 	this->varSize = 1; 
 	this->phases = {true};
 }
 
 //***************************************************************************************
-Polynom::Polynom(int varSize){
-	this->refList = new MyList[varSize+1];
+Polynom::Polynom(int varSize) : arena(new PolyArena()), polySet(std::less<Monom>(), ArenaAllocator<Monom>(arena.get())), setSnapshot(std::less<Monom>(), ArenaAllocator<Monom>(arena.get())) {
+	this->refList = this->newRefList(varSize+1);
 	this->varSize = varSize;
 	this->phases = std::vector<bool>(varSize+1, true);
 }
 
 //***************************************************************************************
-Polynom::Polynom(const Polynom& old){  // Copy constructor
+Polynom::Polynom(const Polynom& old) : arena(new PolyArena()), polySet(std::less<Monom>(), ArenaAllocator<Monom>(arena.get())), setSnapshot(std::less<Monom>(), ArenaAllocator<Monom>(arena.get())) {  // Copy constructor
 	this->varSize = old.varSize;
-	this->refList = new MyList[old.varSize];
-	this->polySet.clear(); 
-	for (std::set<Monom>::iterator it = old.polySet.begin(); it != old.polySet.end(); ++it) {
-		this->addMonom(*it);
+	this->refList = this->newRefList(old.varSize);
+	this->hashBackend = old.hashBackend;
+	this->substitutionThreads = old.substitutionThreads;
+	this->setupShards(old.shardBits);
+	std::vector<Monom*> monoms = old.getMonoms();
+	for (auto& elem: monoms) {
+		this->addMonom(old.reducedCopy(*elem));
 	}
 	this->phases = old.phases;
 }
@@ -39,20 +48,70 @@ Polynom::Polynom(const Polynom& old){  // Copy constructor
 Polynom& Polynom::operator=(const Polynom& other) {  // Assignment operator.
 	if (this != &other) {
 		this->varSize = other.varSize;
+		this->clearMonoms();
 		delete[] this->refList;
-		this->refList = new MyList[other.varSize];
-		this->polySet.clear();
-		for (std::set<Monom>::iterator it = other.polySet.begin(); it != other.polySet.end(); ++it) {
-			this->addMonom(*it);
+		this->resetArenas();
+		this->refList = this->newRefList(other.varSize);
+		this->hashBackend = other.hashBackend;
+		this->substitutionThreads = other.substitutionThreads;
+		this->setupShards(other.shardBits);
+		std::vector<Monom*> monoms = other.getMonoms();
+		for (auto& elem: monoms) {
+			this->addMonom(other.reducedCopy(*elem));
 		}
 		this->phases = other.phases;
 	}
 	return *this;
 }
 
+//***************************************************************************************
+Polynom::Polynom(Polynom&& old) : arena(new PolyArena()), polySet(std::less<Monom>(), ArenaAllocator<Monom>(arena.get())), setSnapshot(std::less<Monom>(), ArenaAllocator<Monom>(arena.get())) {  // Move constructor
+	this->refList = this->newRefList(1);
+	this->varSize = 1;
+	this->phases = {true};
+	this->swapContents(old);
+}
+
+//***************************************************************************************
+Polynom& Polynom::operator=(Polynom&& other) {  // Move assignment operator.
+	if (this != &other) this->swapContents(other);
+	return *this;
+}
+
+//***************************************************************************************
+void Polynom::swapContents(Polynom& other) {
+	std::swap(this->arena, other.arena);  // The containers below take their arena along.
+	this->polySet.swap(other.polySet);
+	this->polyTables.swap(other.polyTables);
+	this->shardArenas.swap(other.shardArenas);
+	std::swap(this->shardBits, other.shardBits);
+	std::swap(this->refListLocks, other.refListLocks);
+	std::swap(this->hashBackend, other.hashBackend);
+	std::swap(this->substitutionThreads, other.substitutionThreads);
+	this->setSnapshot.swap(other.setSnapshot);
+	std::swap(this->refList, other.refList);
+	std::swap(this->varSize, other.varSize);
+	this->phases.swap(other.phases);
+	std::swap(this->modReductionEnabled, other.modReductionEnabled);
+	std::swap(this->coefModReduction, other.coefModReduction);
+	std::swap(this->fixedWidthCoefEnabled, other.fixedWidthCoefEnabled);
+	std::swap(this->wideCoefBits, other.wideCoefBits);
+	std::swap(this->modBits, other.modBits);
+	std::swap(this->lazyModBits, other.lazyModBits);
+	std::swap(this->dirtyTracking, other.dirtyTracking);
+	std::swap(this->allDirty, other.allDirty);
+	std::swap(this->dirtyModNum, other.dirtyModNum);
+	this->dirtyMonoms.swap(other.dirtyMonoms);
+	std::swap(this->proofEnabled, other.proofEnabled);
+	std::swap(this->proofSession, other.proofSession);
+}
+
 //***************************************************************************************
 Polynom::~Polynom(){
+	this->clearMonoms();  // Monomials live in the arena, so remove them before the arena is released.
 	delete[] this->refList;
+	this->setupShards(0);
+	delete this->proofSession;
 }
 
 //***************************************************************************************
@@ -61,58 +120,177 @@ bool Polynom::addPolynom(const Polynom& other) {
 		std::cout << "Cant add big polynom to small polynom (considering variable range). " << std::endl;
 		return false;
 	} else {
-		for (std::set<Monom>::iterator it = other.polySet.begin(); it != other.polySet.end(); ++it) {
-				this->addMonom(*it);
+		std::vector<Monom*> monoms = other.getMonoms();
+		for (auto& elem: monoms) {
+				this->addMonom(other.reducedCopy(*elem));
 		}
 		return true;
 	}
 }
 
 //***************************************************************************************
-Monom* Polynom::addMonom(Monom mon){
-	std::pair<std::set<Monom>::iterator,bool> ret;
-	ret = this->polySet.insert(mon);
-	if (ret.second == false) {  //Monom alredy exists. Just add the factor. Check for 0 factor monoms.
-		if ((ret.first->getFactor() + mon.getFactor()) == 0) {
-			this->eraseMonom(*ret.first);  // Erase monom if factor is set to 0.
+Monom* Polynom::addMonom(const Monom& mon){
+	return this->addMonom(Monom(mon));
+}
+
+//***************************************************************************************
+Monom* Polynom::addMonom(Monom&& mon){
+	this->adaptCoef(mon.factor);
+	if (this->hashBackend) {
+		MonomTable& table = this->tableOf(mon);
+		Monom* target = table.find(mon);
+		if (target != NULL) return this->settleMonom(target, false, mon.factor);
+		target = this->newTableMonom(std::move(mon));
+		table.insert(target);
+		return this->settleMonom(target, true, target->factor);
+	}
+	MonomSet::iterator pos = this->polySet.lower_bound(mon);
+	return this->addMonomAt(std::move(mon), pos);
+}
+
+//***************************************************************************************
+Monom* Polynom::addMonomAt(Monom&& mon, MonomSet::iterator& pos) {
+	Monom* target = NULL;
+	bool inserted = false;
+	if (pos != this->polySet.end() && !(mon < *pos)) {  // Already contained, mon stays untouched.
+		target = &const_cast<Monom&>(*pos);
+	} else {
+		pos = this->polySet.emplace_hint(pos, std::move(mon));
+		target = &const_cast<Monom&>(*pos);
+		inserted = true;
+		this->adoptMonomStorage(*target);
+	}
+	++pos;  // Stays valid if target is erased below.
+	return this->settleMonom(target, inserted, mon.factor);
+}
+
+//***************************************************************************************
+Monom* Polynom::settleMonom(Monom* target, bool inserted, const Coef& coef) {
+	if (inserted == false) {  //Monom alredy exists. Just add the factor. Check for 0 factor monoms.
+		target->factor.add(coef);
+		if (target->factor.isZero()) {
+			this->eraseMonom(*target);  // Erase monom if factor is set to 0.
 			return NULL;
-		} else {
-			ret.first->factor = ret.first->getFactor() + mon.getFactor();
 		}
 	} else { // New monom inserted.
-		varIndex* vars = ret.first->getVars();
-		int size = ret.first->getSize();
+		varIndex* vars = target->getVars();
+		int size = target->getSize();
 		for (int i = 0; i < size; i++) {  // Add reference to newly inserted monomials.
-			this->addRefVar(const_cast<Monom&>(*ret.first), vars[i], i);
+			this->addRefVar(*target, vars[i], i);
 		}	
 	}
-	if (this->modReductionEnabled) {
-		mpz_mod(ret.first->factor.get_mpz_t(), ret.first->factor.get_mpz_t(), this->coefModReduction.get_mpz_t());
-		if (ret.first->getFactor() == 0) {
-			this->eraseMonom(*ret.first); // Erase monom if factor after mod reduction is set to 0.
-			return NULL;
-		}
+	if (this->modReductionEnabled && this->settleCoef(target->factor)) {
+		this->eraseMonom(*target); // Erase monom if factor after mod reduction is set to 0.
+		return NULL;
 	}
-	return &const_cast<Monom&>(*ret.first);
+	this->markDirty(target);
+	return target;
 }
 
 //***************************************************************************************
-void Polynom::eraseMonom(Monom mon) {
+void Polynom::eraseMonom(const Monom& mon) {
 	varIndex var = 0;
+	PolyArena* pool = this->arenaOf(mon);
 	for (int i = 0; i < mon.getSize(); i++) {
 		var = (mon.getVars())[i];
-		this->refList[var].deleteElement(mon.getPtrs()[i]);
-		
+		if (this->concurrentUpdate) {  // Shards are updated in parallel, the refLists are shared by all shards.
+			std::lock_guard<std::mutex> lock(this->refListLocks[var % POLYNOM_REFLIST_LOCKS]);
+			this->refList[var].deleteElement(mon.getPtrs()[i], pool);
+		} else {
+			this->refList[var].deleteElement(mon.getPtrs()[i], pool);
+		}
 	}
-	size_t deletedElements = 0;	
-	deletedElements = this->polySet.erase(mon);
+	if (this->hashBackend) {
+		MonomTable& table = this->tableOf(mon);
+		Monom* target = table.find(mon);
+		if (target == NULL) return;
+		if (target->dirty) this->dirtyMonoms[this->shardOf(target->hashKey)].erase(target);
+		table.erase(target);
+		this->deleteTableMonom(target);
+		return;
+	}
+	MonomSet::iterator it = this->polySet.find(mon);
+	if (it == this->polySet.end()) return;
+	if (it->dirty) this->dirtyMonoms[0].erase(const_cast<Monom*>(&*it));
+	this->releaseMonomStorage(const_cast<Monom&>(*it));
+	this->polySet.erase(it);
+}
+
+//***************************************************************************************
+Monom* Polynom::newTableMonom(Monom&& mon) {
+	Monom* result = new (this->arenaOf(mon)->allocate(sizeof(Monom))) Monom(std::move(mon));
+	this->adoptMonomStorage(*result);
+	return result;
+}
+
+//***************************************************************************************
+void Polynom::deleteTableMonom(Monom* mon) {
+	PolyArena* pool = this->arenaOf(*mon);
+	this->releaseMonomStorage(*mon);
+	mon->~Monom();
+	pool->deallocate(mon, sizeof(Monom));
+}
+
+//***************************************************************************************
+void Polynom::clearMonoms() {
+	for (auto& elem: this->dirtyMonoms) {
+		elem.clear();
+	}
+	this->setSnapshot.clear();
+	this->polySet.clear();
+	std::vector<Monom*> monoms;
+	for (auto& table: this->polyTables) {
+		table.collect(monoms);
+		table.clear();
+	}
+	for (auto& elem: monoms) {
+		this->deleteTableMonom(elem);
+	}
+}
+
+//***************************************************************************************
+MyList* Polynom::newRefList(size_t size) {
+	MyList* lists = new MyList[size];
+	for (size_t i = 0; i < size; i++) {
+		lists[i].setArena(this->arena.get());  // List elements are pooled in the arena of this polynomial.
+	}
+	return lists;
+}
+
+//***************************************************************************************
+void Polynom::adoptMonomStorage(Monom& mon) {
+	if (mon.isInline() || mon.externalStorage) return;
+	size_t varBytes = mon.size * sizeof(varIndex);
+	size_t ptrBytes = mon.size * sizeof(MyList::ListElement*);
+	if (!PolyArena::fits(ptrBytes)) return;  // Very long monomials keep their heap arrays.
+	PolyArena* pool = this->arenaOf(mon);
+	varIndex* vars = static_cast<varIndex*>(pool->allocate(varBytes));
+	MyList::ListElement** ptrs = static_cast<MyList::ListElement**>(pool->allocate(ptrBytes));
+	std::memcpy(vars, mon.vars, varBytes);
+	std::memcpy(ptrs, mon.ptrs, ptrBytes);
+	delete[] mon.vars;
+	delete[] mon.ptrs;
+	mon.vars = vars;
+	mon.ptrs = ptrs;
+	mon.externalStorage = true;
+}
+
+//***************************************************************************************
+void Polynom::releaseMonomStorage(Monom& mon) {
+	if (!mon.externalStorage) return;
+	PolyArena* pool = this->arenaOf(mon);
+	pool->deallocate(mon.vars, mon.size * sizeof(varIndex));
+	pool->deallocate(mon.ptrs, mon.size * sizeof(MyList::ListElement*));
+	mon.externalStorage = false;
+	mon.vars = mon.inlineVars;
+	mon.ptrs = mon.inlinePtrs;
 }
 
 //***************************************************************************************
 void Polynom::createMonom(varIndex index1, mpz_class coef) {
 	Monom tmp(index1);
 	if (coef != 0) tmp.setFactor(coef);
-	this->addMonom(tmp);
+	this->addMonom(std::move(tmp));
 }
 
 //***************************************************************************************
@@ -121,14 +299,14 @@ void Polynom::createMonom(varIndex index1, varIndex index2, mpz_class coef) {
 	if (index2==0) tmp = Monom(index1);
 	else tmp = Monom(index1, index2);
 	if (coef != 0) tmp.setFactor(coef);
-	this->addMonom(tmp);
+	this->addMonom(std::move(tmp));
 }
 
 //***************************************************************************************
 void Polynom::createMonom(varIndex myints[], int size, mpz_class coef) {
 	Monom tmp(myints, size);
 	if (coef != 0) tmp.setFactor(coef);
-	this->addMonom(tmp);
+	this->addMonom(std::move(tmp));
 }
 
 //***************************************************************************************
@@ -406,56 +584,364 @@ void Polynom::replaceCON1(varIndex replace) {
 
 //***************************************************************************************
 void Polynom::replaceVarByPoly(varIndex replace, Polynom& poly) {
-	this->replaceVar(replace, const_cast<std::set<Monom>*>(poly.getSet()));
+	poly.normalizeCoefs();
+	this->replaceVar(replace, poly.getSet());
 }
 
 //***************************************************************************************
 void Polynom::replaceVar(varIndex replace, std::list<Monom>& mons) {
-	if (this->proofEnabled) writeNewPolyAxiom(writeReplacementAxiom(replace, mons));
-	Monom newMon;
-	Monom oldMon;
-	MyList::ListElement* nextElement;
-	Monom* newMonPointer = NULL;
-	std::pair<std::set<Monom>::iterator, bool> retPair;
-	for (MyList::Iterator it=this->refList[replace].begin(); it != this->refList[replace].end(); it = nextElement) {
-		if (refList[replace].isEmpty()) {
-			std::cout << "Reflist Empty. Something went wrong." << std::endl;
-			return;
+	if (this->proofEnabled && this->proofSession) this->proofSession->writeNewPolyAxiom(writeReplacementAxiom(replace, mons));
+	std::vector<const Monom*> tail;
+	tail.reserve(mons.size());
+	for (auto& elem: mons) {
+		tail.push_back(&elem);
+	}
+	this->substitute(replace, tail);
+}
+
+//***************************************************************************************
+void Polynom::replaceVar(varIndex replace, std::set<Monom>* mons) {
+	if (this->proofEnabled && this->proofSession) this->proofSession->writeNewPolyAxiom(writeReplacementAxiom(replace, mons));
+	std::vector<const Monom*> tail;
+	tail.reserve(mons->size());
+	for (auto& elem: *mons) {
+		tail.push_back(&elem);
+	}
+	this->substitute(replace, tail);
+}
+
+//***************************************************************************************
+void Polynom::replaceVar(varIndex replace, const MonomSet* mons) {
+	if (this->proofEnabled && this->proofSession) {
+		std::list<Monom> tailList(mons->begin(), mons->end());
+		this->proofSession->writeNewPolyAxiom(writeReplacementAxiom(replace, tailList));
+	}
+	std::vector<const Monom*> tail;
+	tail.reserve(mons->size());
+	for (auto& elem: *mons) {
+		tail.push_back(&elem);
+	}
+	this->substitute(replace, tail);
+}
+
+//***************************************************************************************
+// Merge the sorted variables of a stripped monomial and a tail monomial into out, skipping duplicates and the replaced variable.
+// sum and hashKey start with the values of the stripped monomial and are updated by the new variables. Returns the size of the product.
+static int mergeProduct(const std::vector<varIndex>& stripped, const varIndex* tailVars, int tailSize, varIndex replace, varIndex* out, int& sum, uint64_t& hashKey) {
+	int size = 0;
+	size_t i = 0;
+	int j = 0;
+	while (i < stripped.size() || j < tailSize) {
+		if (j < tailSize && tailVars[j] == replace) { j++; continue; }
+		if (j == tailSize || (i < stripped.size() && stripped[i] < tailVars[j])) {
+			out[size++] = stripped[i++];
+		} else {
+			if (i < stripped.size() && stripped[i] == tailVars[j]) i++;  // Contained in both.
+			else { sum += tailVars[j]; hashKey += Monom::varKey(tailVars[j]); }
+			out[size++] = tailVars[j++];
 		}
-		oldMon = *(it.returnData());
-		nextElement = it.returnElement()->next;  // Save address of next element before deleting current element.
-		this->eraseMonom(*(it.returnData()));  // ATTENTION: Iterator on the current element gets invalid.
-		it = this->refList[replace].begin();
-		for (std::list<Monom>::iterator it2=mons.begin(); it2 != mons.end(); ++it2) {
-			newMon = oldMon.merge(replace, *it2);
-			if (newMon.getFactor() == 0) continue; // Dont add monom with factor 0. Only caused by XOR with same inputs.
-			newMonPointer = this->addMonom(newMon);
+	}
+	return size;
+}
+
+//***************************************************************************************
+int Polynom::compareProducts(const SubstProduct& a, const varIndex* aVars, const SubstProduct& b, const varIndex* bVars) {
+	if (a.sum != b.sum) return a.sum < b.sum ? -1 : 1;
+	if (a.size != b.size) return a.size < b.size ? -1 : 1;
+	for (int i = 0; i < a.size; i++) {
+		if (aVars[a.offset + i] != bVars[b.offset + i]) return aVars[a.offset + i] < bVars[b.offset + i] ? -1 : 1;
+	}
+	return 0;
+}
+
+//***************************************************************************************
+void Polynom::substitute(varIndex replace, const std::vector<const Monom*>& tail) {
+	size_t products = (size_t)this->refList[replace].getSize() * tail.size();
+	int workers = 1;
+	if (products >= POLYNOM_PARALLEL_THRESHOLD) workers = (this->shardBits > 0) ? this->getShards() : this->substitutionThreads;
+	if (workers > 1 || (!this->hashBackend && products >= POLYNOM_BULK_THRESHOLD)) {
+		this->substituteBulk(replace, tail, workers);
+		return;
+	}
+	size_t maxTailSize = 0;
+	for (auto& elem: tail) {
+		maxTailSize = std::max(maxTailSize, (size_t)elem->size);
+	}
+	// Scratch buffers, reused for all products. product is only copied into the polynomial if it is new.
+	std::vector<varIndex> stripped;
+	std::vector<varIndex> productVars;
+	std::vector<MyList::ListElement*> productPtrs;
+	Monom product;
+	Coef oldFactor;
+	while (!this->refList[replace].isEmpty()) {
+		Monom* oldMon = this->refList[replace].begin()->data;
+		// Strip the replaced variable from the old monomial once, then remove it from the polynomial.
+		stripped.clear();
+		for (int i = 0; i < oldMon->size; i++) {
+			if (oldMon->vars[i] != replace) stripped.push_back(oldMon->vars[i]);
+		}
+		int strippedSum = oldMon->sum - replace;
+		uint64_t strippedHash = oldMon->hashKey - Monom::varKey(replace);
+		oldFactor = std::move(oldMon->factor);
+		this->eraseMonom(*oldMon);
+		if (productVars.size() < stripped.size() + maxTailSize) {
+			productVars.resize(stripped.size() + maxTailSize);
+			productPtrs.resize(stripped.size() + maxTailSize);
+		}
+		for (auto& elem: tail) {
+			product.factor.mul(oldFactor, elem->factor);
+			if (product.factor.isZero()) continue;  // Dont add monom with factor 0. Only caused by XOR with same inputs.
+			product.sum = strippedSum;
+			product.hashKey = strippedHash;
+			product.size = mergeProduct(stripped, elem->vars, elem->size, replace, productVars.data(), product.sum, product.hashKey);
+			product.vars = productVars.data();
+			product.ptrs = productPtrs.data();
+			product.externalStorage = true;
+			this->addMonom(std::move(product));  // Probes the polynomial in place, the scratch arrays stay with product.
 		}
 	}
 }
 
 //***************************************************************************************
-void Polynom::replaceVar(varIndex replace, std::set<Monom>* mons) {
-	if (this->proofEnabled) writeNewPolyAxiom(writeReplacementAxiom(replace, mons));
-	Monom newMon;
-	Monom oldMon;
-	MyList::ListElement* nextElement;
-	Monom* newMonPointer = NULL;
-	std::pair<std::set<Monom>::iterator, bool> retPair;
-	for (MyList::Iterator it=this->refList[replace].begin(); it != this->refList[replace].end(); it = nextElement) {
-		if (refList[replace].isEmpty()) {
-			std::cout << "Reflist Empty. Something went wrong." << std::endl;
-			return;
+void Polynom::collectProducts(const std::vector<const Monom*>& oldMons, size_t begin, size_t end, const std::vector<const Monom*>& tail, varIndex replace, int shardBits, ProductBuffer& buf) {
+	size_t maxTailSize = 0;
+	for (auto& elem: tail) {
+		maxTailSize = std::max(maxTailSize, (size_t)elem->size);
+	}
+	std::vector<varIndex> stripped;
+	std::vector<SubstProduct>& products = buf.products;
+	products.reserve((end - begin) * tail.size());
+	for (size_t k = begin; k < end; k++) {
+		const Monom* oldMon = oldMons[k];
+		stripped.clear();
+		for (int i = 0; i < oldMon->size; i++) {
+			if (oldMon->vars[i] != replace) stripped.push_back(oldMon->vars[i]);
 		}
-		oldMon = *(it.returnData());
-		nextElement = it.returnElement()->next;  // Save address of next element before deleting current element.
-		this->eraseMonom(*(it.returnData()));  // ATTENTION: Iterator on the current element gets invalid.
-		it = this->refList[replace].begin();
-		for (std::set<Monom>::iterator it2=mons->begin(); it2 != mons->end(); ++it2) {
-			newMon = oldMon.merge(replace, *it2);
-			if (newMon.getFactor() == 0) continue; // Dont add monom with factor 0. Only caused by XOR with same inputs.
-			newMonPointer = this->addMonom(newMon);
+		int strippedSum = oldMon->sum;
+		uint64_t strippedHash = oldMon->hashKey;
+		if ((int)stripped.size() != oldMon->size) {
+			strippedSum -= replace;
+			strippedHash -= Monom::varKey(replace);
+		}
+		for (auto& elem: tail) {
+			products.emplace_back();
+			SubstProduct& product = products.back();
+			product.factor.mul(oldMon->factor, elem->factor);
+			if (product.factor.isZero()) {  // Dont add monom with factor 0. Only caused by XOR with same inputs.
+				products.pop_back();
+				continue;
+			}
+			product.offset = buf.pool.size();
+			buf.pool.resize(buf.pool.size() + stripped.size() + maxTailSize);
+			product.sum = strippedSum;
+			product.hashKey = strippedHash;
+			product.size = mergeProduct(stripped, elem->vars, elem->size, replace, buf.pool.data() + product.offset, product.sum, product.hashKey);
+			buf.pool.resize(product.offset + product.size);
+			buf.maxSize = std::max(buf.maxSize, product.size);
+		}
+	}
+	// Sort the products in the order of polySet, grouped by shard, and combine equal neighbours, dropping products which cancel each other.
+	// Equal products have the same hash and thus the same shard.
+	const varIndex* vars = buf.pool.data();
+	int shift = (shardBits == 0) ? 0 : 64 - shardBits;
+	std::sort(products.begin(), products.end(), [vars, shardBits, shift](const SubstProduct& a, const SubstProduct& b) {
+		if (shardBits > 0 && (a.hashKey >> shift) != (b.hashKey >> shift)) return (a.hashKey >> shift) < (b.hashKey >> shift);
+		return compareProducts(a, vars, b, vars) < 0;
+	});
+	size_t kept = 0;
+	size_t i = 0;
+	while (i < products.size()) {
+		size_t j = i + 1;
+		while (j < products.size() && products[j].hashKey == products[i].hashKey && compareProducts(products[i], vars, products[j], vars) == 0) {
+			products[i].factor.add(products[j].factor);
+			j++;
+		}
+		if (!products[i].factor.isZero()) {
+			if (kept != i) products[kept] = std::move(products[i]);
+			kept++;
 		}
+		i = j;
+	}
+	products.erase(products.begin() + kept, products.end());
+	if (shardBits == 0) return;
+	size_t shards = (size_t)1 << shardBits;
+	buf.shardBegin.assign(shards + 1, products.size());
+	for (size_t k = products.size(); k > 0; k--) {
+		buf.shardBegin[products[k - 1].hashKey >> shift] = k - 1;
+	}
+	for (size_t s = shards; s > 0; s--) {  // Empty runs start where the next run starts.
+		buf.shardBegin[s - 1] = std::min(buf.shardBegin[s - 1], buf.shardBegin[s]);
+	}
+}
+
+//***************************************************************************************
+void Polynom::collectParallel(const std::vector<const Monom*>& oldMons, const std::vector<const Monom*>& tail, varIndex replace, int shardBits, std::vector<ProductBuffer>& buffers) {
+	size_t count = buffers.size();
+	std::vector<std::thread> threads;
+	for (size_t w = 1; w < count; w++) {
+		threads.emplace_back(Polynom::collectProducts, std::cref(oldMons), oldMons.size() * w / count, oldMons.size() * (w + 1) / count,
+				std::cref(tail), replace, shardBits, std::ref(buffers[w]));
+	}
+	Polynom::collectProducts(oldMons, 0, oldMons.size() / count, tail, replace, shardBits, buffers[0]);
+	for (auto& elem: threads) {
+		elem.join();
+	}
+}
+
+//***************************************************************************************
+void Polynom::substituteBulk(varIndex replace, const std::vector<const Monom*>& tail, int workers) {
+	std::vector<const Monom*> oldMons;
+	oldMons.reserve(this->refList[replace].getSize());
+	for (MyList::Iterator it=this->refList[replace].begin(); it != this->refList[replace].end(); it++) {
+		oldMons.push_back(it.returnData());
+	}
+	// 1) Compute the products. Every worker takes a contiguous range of the old monomials and only reads the polynomial.
+	std::vector<ProductBuffer> buffers(std::max((size_t)1, std::min((size_t)workers, oldMons.size())));
+	Polynom::collectParallel(oldMons, tail, replace, this->shardBits, buffers);
+	if (this->shardBits > 0) {
+		this->mergeSharded(oldMons, buffers);
+		return;
+	}
+	size_t count = buffers.size();
+	// 2) Remove the old monomials.
+	while (!this->refList[replace].isEmpty()) {
+		this->eraseMonom(*this->refList[replace].begin()->data);
+	}
+	// 3) Merge the sorted buffers into the polynomial in one ordered pass. Equal products of different workers are combined first,
+	//    so the result does not depend on the number of workers. For polySet the position of the previous product is the hint
+	//    for the next one, only if it is far behind we search from the root again.
+	int maxSize = 0;
+	for (auto& buf: buffers) {
+		maxSize = std::max(maxSize, buf.maxSize);
+	}
+	std::vector<MyList::ListElement*> productPtrs(maxSize);
+	Monom product;  // Scratch monomial pointing into the pools, only copied if it is new.
+	product.externalStorage = true;
+	product.ptrs = productPtrs.data();
+	std::vector<size_t> cursor(count, 0);
+	MonomSet::iterator pos = this->polySet.begin();
+	while (true) {
+		size_t from = count;
+		for (size_t w = 0; w < count; w++) {
+			if (cursor[w] == buffers[w].products.size()) continue;
+			if (from == count || compareProducts(buffers[w].products[cursor[w]], buffers[w].pool.data(), buffers[from].products[cursor[from]], buffers[from].pool.data()) < 0) from = w;
+		}
+		if (from == count) break;
+		SubstProduct& first = buffers[from].products[cursor[from]++];
+		for (size_t w = from + 1; w < count; w++) {  // Every buffer holds each product at most once.
+			if (cursor[w] == buffers[w].products.size()) continue;
+			SubstProduct& other = buffers[w].products[cursor[w]];
+			if (other.hashKey != first.hashKey || compareProducts(first, buffers[from].pool.data(), other, buffers[w].pool.data()) != 0) continue;
+			first.factor.add(other.factor);
+			cursor[w]++;
+		}
+		if (first.factor.isZero()) continue;  // Products of different workers cancelled each other.
+		product.vars = buffers[from].pool.data() + first.offset;
+		product.size = first.size;
+		product.sum = first.sum;
+		product.hashKey = first.hashKey;
+		product.factor = std::move(first.factor);
+		this->adaptCoef(product.factor);
+		if (this->hashBackend) {
+			this->addMonom(std::move(product));
+			continue;
+		}
+		int steps = 0;
+		while (pos != this->polySet.end() && *pos < product && steps < 8) {
+			++pos;
+			++steps;
+		}
+		if (pos != this->polySet.end() && *pos < product) pos = this->polySet.lower_bound(product);
+		this->addMonomAt(std::move(product), pos);
+	}
+}
+
+//***************************************************************************************
+void Polynom::mergeSharded(const std::vector<const Monom*>& oldMons, std::vector<ProductBuffer>& buffers) {
+	size_t shards = this->polyTables.size();
+	std::vector<std::vector<const Monom*> > erase(shards);  // Split up front, the threads free monomials of other shards.
+	for (auto& elem: oldMons) {
+		erase[this->shardOf(elem->hashKey)].push_back(elem);
+	}
+	std::vector<std::vector<Monom*> > inserted(shards);
+	this->concurrentUpdate = true;
+	std::vector<std::thread> threads;
+	for (size_t s = 1; s < shards; s++) {
+		threads.emplace_back(&Polynom::mergeShard, this, s, std::cref(erase[s]), std::ref(buffers), std::ref(inserted[s]));
+	}
+	this->mergeShard(0, erase[0], buffers, inserted[0]);
+	for (auto& elem: threads) {
+		elem.join();
+	}
+	this->concurrentUpdate = false;
+	// Register the new monomials in the refLists in the order of Monom::operator<, like the unsharded bulk substitution does.
+	std::vector<Monom*> all;
+	for (auto& elem: inserted) {
+		all.insert(all.end(), elem.begin(), elem.end());
+	}
+	std::sort(all.begin(), all.end(), lessMonomPointer);
+	for (auto& elem: all) {
+		for (int i = 0; i < elem->size; i++) {
+			this->addRefVar(*elem, elem->vars[i], i);
+		}
+	}
+}
+
+//***************************************************************************************
+void Polynom::mergeShard(size_t shard, const std::vector<const Monom*>& oldMons, std::vector<ProductBuffer>& buffers, std::vector<Monom*>& inserted) {
+	MonomTable& table = this->polyTables[shard];
+	for (auto& elem: oldMons) {
+		this->eraseMonom(*elem);
+	}
+	// Same merge as in substituteBulk, restricted to the runs of this shard. Equal products always fall into the same shard.
+	size_t count = buffers.size();
+	int maxSize = 0;
+	for (auto& buf: buffers) {
+		maxSize = std::max(maxSize, buf.maxSize);
+	}
+	std::vector<MyList::ListElement*> productPtrs(maxSize);
+	Monom product;  // Scratch monomial pointing into the pools, only copied if it is new.
+	product.externalStorage = true;
+	product.ptrs = productPtrs.data();
+	std::vector<size_t> cursor(count);
+	std::vector<size_t> end(count);
+	for (size_t w = 0; w < count; w++) {
+		cursor[w] = buffers[w].shardBegin[shard];
+		end[w] = buffers[w].shardBegin[shard + 1];
+	}
+	while (true) {
+		size_t from = count;
+		for (size_t w = 0; w < count; w++) {
+			if (cursor[w] == end[w]) continue;
+			if (from == count || compareProducts(buffers[w].products[cursor[w]], buffers[w].pool.data(), buffers[from].products[cursor[from]], buffers[from].pool.data()) < 0) from = w;
+		}
+		if (from == count) break;
+		SubstProduct& first = buffers[from].products[cursor[from]++];
+		for (size_t w = from + 1; w < count; w++) {
+			if (cursor[w] == end[w]) continue;
+			SubstProduct& other = buffers[w].products[cursor[w]];
+			if (other.hashKey != first.hashKey || compareProducts(first, buffers[from].pool.data(), other, buffers[w].pool.data()) != 0) continue;
+			first.factor.add(other.factor);
+			cursor[w]++;
+		}
+		if (first.factor.isZero()) continue;
+		product.vars = buffers[from].pool.data() + first.offset;
+		product.size = first.size;
+		product.sum = first.sum;
+		product.hashKey = first.hashKey;
+		product.factor = std::move(first.factor);
+		this->adaptCoef(product.factor);
+		Monom* target = table.find(product);
+		if (target != NULL) {
+			this->settleMonom(target, false, product.factor);
+			continue;
+		}
+		// New monomial. Its references are added after all shards are done, so reduce before inserting.
+		if (this->modReductionEnabled && this->settleCoef(product.factor)) continue;
+		target = this->newTableMonom(std::move(product));
+		table.insert(target);
+		this->markDirty(target);
+		inserted.push_back(target);
 	}
 }
 
@@ -467,7 +953,7 @@ void Polynom::replaceVarWithQuotients(varIndex replace, std::list<Monom>& mons,
 	con1.setFactor(1);
 	MyList::ListElement* nextElement;
 	Monom* newMonPointer = NULL;
-	std::pair<std::set<Monom>::iterator, bool> retPair;
+	std::pair<MonomSet::iterator, bool> retPair;
 	for (MyList::Iterator it=this->refList[replace].begin(); it != this->refList[replace].end(); it = nextElement) {
 		if (refList[replace].isEmpty()) {
 			std::cout << "Reflist Empty. Something went wrong." << std::endl;
@@ -480,8 +966,8 @@ void Polynom::replaceVarWithQuotients(varIndex replace, std::list<Monom>& mons,
 		quotientStrVec.push_back(this->monToStringOpt(oldMon.merge(replace, con1)));
 		for (std::list<Monom>::iterator it2=mons.begin(); it2 != mons.end(); ++it2) {
 			newMon = oldMon.merge(replace, *it2);
-			if (newMon.getFactor() == 0) continue; // Dont add monom with factor 0. Only caused by XOR with same inputs.
-			newMonPointer = this->addMonom(newMon);
+			if (newMon.factor.isZero()) continue; // Dont add monom with factor 0. Only caused by XOR with same inputs.
+			newMonPointer = this->addMonom(std::move(newMon));
 		}
 	}
 }
@@ -645,15 +1131,16 @@ bool Polynom::testPhaseChangeSingleVariableImproved(varIndex var) {
 	for (auto& elem: oldPointers) {
 		addedMons.push_back(elem->merge(var, tmpMon));
 		this->addMonom(addedMons.back());
-		mpz_neg(elem->factor.get_mpz_t(), elem->factor.get_mpz_t());
+		this->negateCoef(elem->factor);
+		this->markDirty(elem);
 	}
 	if (sizeBefore <= this->size()) { // Revert the negation.
 		for (auto& elem: addedMons) {
-			mpz_neg(elem.factor.get_mpz_t(), elem.factor.get_mpz_t());
+			elem.factor.neg();
 			this->addMonom(elem);  // Erase previosuly added monoms.
 		}
 		for (auto& elem: oldPointers) {
-			mpz_neg(elem->factor.get_mpz_t(), elem->factor.get_mpz_t());
+			this->negateCoef(elem->factor);
 		}
 		return false;
 	} else {  // Keep the negation.
@@ -670,10 +1157,11 @@ void Polynom::negateVarImproved(varIndex var) {
 	tmpMon.setFactor(1);
 	for (auto& elem: oldPointers) {
 		this->addMonom(elem->merge(var, tmpMon));
-		mpz_neg(elem->factor.get_mpz_t(), elem->factor.get_mpz_t());
+		elem->factor.neg();
 		if (modReductionEnabled) {  // If modulo reduction is enabled, apply modulo to the negated factors.
-			mpz_mod(elem->factor.get_mpz_t(), elem->factor.get_mpz_t(), this->coefModReduction.get_mpz_t());
+			this->reduceCoef(elem->factor);
 		}
+		this->markDirty(elem);
 	}
 	this->phases[var] = !this->phases[var];
 }
@@ -688,7 +1176,8 @@ void Polynom::negateVarImprovedWithQuotient(varIndex var, std::vector<Monom>& qu
 	for (auto& elem: oldPointers) {
 		quotientStrVec.push_back(monToStringWithPhasesOpt(elem->merge(var, con1Mon)));
 		this->addMonom(elem->merge(var, con1Mon));
-		mpz_neg(elem->factor.get_mpz_t(), elem->factor.get_mpz_t());
+		this->negateCoef(elem->factor);
+		this->markDirty(elem);
 	}
 	this->phases[var] = !this->phases[var];
 }
@@ -768,7 +1257,7 @@ std::vector<Monom*> Polynom::findContainingVar(varIndex var) {
 	// Retrieve all monomials from refList which contain var.
 	bool add;
 	for (MyList::Iterator it=this->refList[var].begin(); it != this->refList[var].end(); it++) {
-		resultVec.push_back(it.returnData());
+		resultVec.push_back(this->normalizeCoef(it.returnData()));
 	}
 	return resultVec;
 }
@@ -800,7 +1289,7 @@ std::vector<Monom*> Polynom::findContaining(Monom& mon) {
 				break;
 			}
 		}
-		if (add) resultVec.push_back(it.returnData());
+		if (add) resultVec.push_back(this->normalizeCoef(it.returnData()));
 	}
 	return resultVec;
 }
@@ -809,10 +1298,12 @@ std::vector<Monom*> Polynom::findContaining(Monom& mon) {
 //****************************************************************************************************************************
 Monom* Polynom::findExact(Monom& mon) {
 	// First check if special case: mon is the empty monomial (only a coefficient without variables).
+	if (this->hashBackend) return this->normalizeCoef(this->tableOf(mon).find(mon));  // Direct lookup by hash.
 	Monom* temp;
 	if (mon.getSize() == 0) {  // If size=0 it is the empty monomial which is always first in polySet
+		if (this->polySet.empty()) return NULL;
 		temp = &const_cast<Monom&>(*this->polySet.begin());
-		if (temp->getSize() == 0) return &const_cast<Monom&>(*this->polySet.begin());
+		if (temp->getSize() == 0) return this->normalizeCoef(temp);
 		else return NULL;
 	}
 	int minListLength = INT_MAX;
@@ -831,7 +1322,7 @@ Monom* Polynom::findExact(Monom& mon) {
 	// Find exact monomial mon from shortest refList.
 	for (MyList::Iterator it=this->refList[minListVar].begin(); it != this->refList[minListVar].end(); it++) {
 		if (*(it.returnData()) == mon) {
-			return it.returnData();
+			return this->normalizeCoef(it.returnData());
 		} 
 	}
 	return NULL;  // This case should never happen.
@@ -857,12 +1348,12 @@ int Polynom::phaseChangeEffectOnMonom(Monom& mon, varIndex var) {
 			if (minListLength == 0) return NULL;  // If one refList length is zero, this variable is not contained, so mon cannot be contained in polynomial.
 		}
 	}
-	// Find monomial which is the same except that var is missing. Use sum to faster find candidates.
-	int64_t findSum = mon.getSum() - var;
+	// Find monomial which is the same except that var is missing. Use hash to faster find candidates.
+	uint64_t findHash = mon.hash() - Monom::varKey(var);
 	size_t findSize = mon.getSize() - 1;
 	int polySizeChange = 1;  // If monomial not found we add 1 to the poly size. If found we either dont change size or reduce by 1.
 	for (MyList::Iterator it=this->refList[minListVar].begin(); it != this->refList[minListVar].end(); it++) {
-		if ((it.returnData())->getSum() != findSum) continue;
+		if ((it.returnData())->hash() != findHash) continue;
 		if ((it.returnData())->getSize() != findSize) continue;
 		varIndex currVar;
 		varIndex monVar;
@@ -878,8 +1369,14 @@ int Polynom::phaseChangeEffectOnMonom(Monom& mon, varIndex var) {
 		if (conOuter) continue;  // Check next monomial.
 		// Searched monomial found. Poly size is not increased. If coefficient is negative of mon we even reduce poly size by 1.
 		polySizeChange = 0;
-		if ((it.returnData())->factor == (-1 * mon.factor)) polySizeChange = -1;
-		if ((it.returnData())->factor + mon.factor == this->coefModReduction) polySizeChange = -1;
+		if (this->lazyModReduction()) {  // Coefficients may be unreduced, so they cancel if their sum is 0 modulo 2^modBits.
+			Coef sum = (it.returnData())->factor;
+			sum.add(mon.factor);
+			if (sum.isZeroModPow2(this->modBits)) polySizeChange = -1;
+			break;
+		}
+		if ((it.returnData())->getFactor() == (-1 * mon.getFactor())) polySizeChange = -1;
+		if ((it.returnData())->getFactor() + mon.getFactor() == this->coefModReduction) polySizeChange = -1;
 		break;
 	}
 	return polySizeChange;  // This case should never happen.
@@ -899,13 +1396,120 @@ bool Polynom::containsVar(varIndex var) {
 
 //***************************************************************************************
 void Polynom::addRefVar(Monom& mon, varIndex index, int i) {
-	(mon.ptrs)[i] = this->refList[index].add(&mon);
+	(mon.ptrs)[i] = this->refList[index].add(&mon, this->arenaOf(mon));
 	return;
 }
 
 //***************************************************************************************
-const std::set<Monom>* Polynom::getSet() const {
-	return &this->polySet;
+const MonomSet* Polynom::getSet() const {
+	if (!this->hashBackend) return &this->polySet;
+	// Hash backend: build an ordered copy on demand.
+	this->setSnapshot.clear();
+	std::vector<Monom*> monoms = this->getMonoms();
+	for (auto& elem: monoms) {
+		this->setSnapshot.insert(this->setSnapshot.end(), *elem);
+	}
+	return &this->setSnapshot;
+}
+
+//***************************************************************************************
+std::vector<Monom*> Polynom::getMonoms(bool ordered) const {
+	std::vector<Monom*> result;
+	if (this->hashBackend) {
+		for (auto& table: this->polyTables) {
+			table.collect(result);
+		}
+		if (ordered) std::sort(result.begin(), result.end(), lessMonomPointer);
+	} else {
+		result.reserve(this->polySet.size());
+		for (MonomSet::const_iterator it = this->polySet.begin(); it != this->polySet.end(); ++it) {
+			result.push_back(&const_cast<Monom&>(*it));
+		}
+	}
+	return result;
+}
+
+//***************************************************************************************
+void Polynom::setHashBackend(bool mode) {
+	if (mode == this->hashBackend) return;
+	this->rebuildContainer(mode, 0);
+}
+
+//***************************************************************************************
+bool Polynom::getHashBackend() const {
+	return this->hashBackend;
+}
+
+//***************************************************************************************
+void Polynom::setShards(int shards) {
+	int bits = 0;
+	while (bits < 16 && (1 << bits) < shards) bits++;
+	if (bits == this->shardBits) return;
+	this->rebuildContainer(this->hashBackend || bits > 0, bits);
+}
+
+//***************************************************************************************
+int Polynom::getShards() const {
+	return 1 << this->shardBits;
+}
+
+//***************************************************************************************
+void Polynom::rebuildContainer(bool hash, int bits) {
+	std::vector<Monom*> pointers = this->getMonoms();
+	std::vector<Monom> monoms;
+	monoms.reserve(pointers.size());
+	for (auto& elem: pointers) {
+		monoms.push_back(*elem);
+	}
+	for (auto& elem: monoms) {  // Removes the monomials and their references from the old container.
+		this->eraseMonom(elem);
+	}
+	this->hashBackend = hash;
+	this->setupShards(hash ? bits : 0);
+	this->clearDirtyMonoms();  // The monomials were inserted again and have new addresses.
+	this->allDirty = true;
+	for (auto& elem: monoms) {
+		this->addMonom(std::move(elem));
+	}
+}
+
+//***************************************************************************************
+void Polynom::setupShards(int bits) {
+	size_t shards = (size_t)1 << bits;
+	this->shardBits = bits;
+	this->polyTables.resize(shards);
+	this->dirtyMonoms.resize(shards);
+	while (this->shardArenas.size() + 1 > shards) {
+		delete this->shardArenas.back();
+		this->shardArenas.pop_back();
+	}
+	while (this->shardArenas.size() + 1 < shards) {
+		this->shardArenas.push_back(new PolyArena());
+	}
+	if (bits > 0 && this->refListLocks == NULL) this->refListLocks = new std::mutex[POLYNOM_REFLIST_LOCKS];
+	if (bits == 0) {
+		delete[] this->refListLocks;
+		this->refListLocks = NULL;
+	}
+}
+
+//***************************************************************************************
+void Polynom::resetArenas() {
+	this->arena->reset();
+	for (auto& elem: this->shardArenas) {
+		elem->reset();
+	}
+}
+
+//***************************************************************************************
+void Polynom::setSubstitutionThreads(int threads) {
+	if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+	this->substitutionThreads = threads;
+}
+
+//***************************************************************************************
+int Polynom::getSubstitutionThreads() const {
+	return this->substitutionThreads;
 }
 
 //***************************************************************************************
@@ -931,15 +1535,23 @@ size_t Polynom::getVarSize() {
 
 //***************************************************************************************
 size_t Polynom::size() {
+	if (this->hashBackend) {
+		size_t result = 0;
+		for (auto& table: this->polyTables) {
+			result += table.size();
+		}
+		return result;
+	}
 	return this->polySet.size();
 }
 
 
 //***************************************************************************************
 void Polynom::resize(size_t varSize) {
+	this->clearMonoms();
 	delete[] this->refList;
-	this->polySet.clear();
-	this->refList = new MyList[varSize];
+	this->resetArenas();  // Release all monomial storage at once.
+	this->refList = this->newRefList(varSize);
 	this->phases= std::vector<bool>(varSize+1, true);
 	this->varSize = varSize;
 }
@@ -954,11 +1566,22 @@ Polynom Polynom::multiplyPoly(Polynom& p1, Polynom& p2) {
 	}
 	Polynom mult(maxSize);
 	
-	Monom temp;
-	for (std::set<Monom>::iterator it= p1.polySet.begin(); it != p1.polySet.end(); ++it) {
-		for (std::set<Monom>::iterator it2= p2.polySet.begin(); it2 != p2.polySet.end(); ++it2) {
-			temp = Monom::multiply(*it, *it2);
-			mult.addMonom(temp);
+	p1.normalizeCoefs();  // The product is not reduced, so it has to be built from the reduced coefficients.
+	p2.normalizeCoefs();
+	std::vector<Monom*> monoms1 = p1.getMonoms();
+	std::vector<Monom*> monoms2 = p2.getMonoms();
+	if (p1.shardBits > 0 && monoms1.size() * monoms2.size() >= POLYNOM_PARALLEL_THRESHOLD) {  // Multiply in parallel into a sharded result.
+		mult.setShards(p1.getShards());
+		std::vector<const Monom*> factors1(monoms1.begin(), monoms1.end());
+		std::vector<const Monom*> factors2(monoms2.begin(), monoms2.end());
+		std::vector<ProductBuffer> buffers(std::max((size_t)1, std::min((size_t)mult.getShards(), factors1.size())));
+		Polynom::collectParallel(factors1, factors2, -1, mult.shardBits, buffers);  // No variable is replaced.
+		mult.mergeSharded(std::vector<const Monom*>(), buffers);
+		return mult;
+	}
+	for (auto& elem1: monoms1) {
+		for (auto& elem2: monoms2) {
+			mult.addMonom(Monom::multiply(*elem1, *elem2));
 		}
 	}
 	
@@ -967,44 +1590,9 @@ Polynom Polynom::multiplyPoly(Polynom& p1, Polynom& p2) {
 
 //***************************************************************************************
 void Polynom::parsePolyFromString(std::string inputStr) {
-	std::vector<std::string> monomialStrings;
-	std::vector<std::string> variableStrings;
-	std::regex monDelimit("([+-]?[^+-]+)");
-	std::sregex_token_iterator it(inputStr.begin(), inputStr.end(), monDelimit);
-	std::sregex_token_iterator end;
-	for (; it != end; ++it) {
-        monomialStrings.push_back(it->str());
-    }
-	int highestIndex = 0;
-	std::vector<Monom> monomials;
-
-	for (auto& elem: monomialStrings) {
-		variableStrings.clear();
-		std::regex varDelimit("[*]");
-		std::sregex_token_iterator it(elem.begin(), elem.end(), varDelimit, -1);
-		std::sregex_token_iterator end;
-		for (; it != end; ++it) {
-    	    variableStrings.push_back(it->str());
-    	}
-		std::string currStr;
-		mpz_class tmpCoef;
-		int* tmpVars = new int[variableStrings.size() - 1];
-		int tmpSum = 0;
-		for (size_t i=0; i < variableStrings.size(); ++i) {
-			currStr = variableStrings[i];
-			if (i==0) {
-				size_t pos = 0;
-				if ((pos = currStr.find("+")) != std::string::npos) currStr.erase(pos, 1);
-				tmpCoef = mpz_class(currStr);
-			} else {
-				currStr.erase(currStr.find("x"), 1);
-				tmpVars[i-1] = std::stoi(currStr);
-				tmpSum += tmpVars[i-1];
-			}
-		}
-		Monom tmpMon(tmpVars, variableStrings.size() - 1, tmpSum, tmpCoef);
-		delete[] tmpVars;
-		this->addMonom(tmpMon);
+	MonomScanner scanner(inputStr);
+	while (scanner.next()) {
+		this->addMonom(scanner.toMonom(false));
 	}
 }
 
@@ -1012,12 +1600,14 @@ void Polynom::parsePolyFromString(std::string inputStr) {
 std::ostream& operator<<(std::ostream& stdout, const Polynom& obj) {
     std::string start = "", end = "", delim = " + ";
     std::string s;
-    int size = obj.getSet()->size();
-    if (!obj.getSet()->empty()){
+    std::vector<Monom*> monoms = obj.getMonoms();
+    Monom scratch;
+    int size = monoms.size();
+    if (!monoms.empty()){
         s += start;
         int num = 0;
-        for (std::set<Monom>::iterator it=obj.getSet()->begin(); it != obj.getSet()->end(); ++it) {
-            s += (*it).to_string();
+        for (auto& elem: monoms) {
+            s += obj.printable(*elem, scratch).to_string();
             num += 1;
             if (num != size) s += delim;
         }
@@ -1042,12 +1632,14 @@ const std::string Polynom::to_string() const {
 const std::string Polynom::to_string_reverse() const {
     std::string start = "", end = "", delim = " + ";
     std::string s;
-    int size = this->getSet()->size();
-    if (!this->getSet()->empty()){
+    std::vector<Monom*> monoms = this->getMonoms();
+    Monom scratch;
+    int size = monoms.size();
+    if (!monoms.empty()){
         s += start;
         int num = 0;
-        for (std::set<Monom>::reverse_iterator it=this->getSet()->rbegin(); it != this->getSet()->rend(); ++it) {
-            s += (*it).to_string_reverse();
+        for (std::vector<Monom*>::reverse_iterator it=monoms.rbegin(); it != monoms.rend(); ++it) {
+            s += this->printable(**it, scratch).to_string_reverse();
             num += 1;
             if (num != size) s += delim;
         }
@@ -1065,13 +1657,15 @@ std::string Polynom::to_string_with_phases() const {
     std::string start = "", end = "", delim = " + ";
     std::string str;
 	std::string tmp;
-    int size = this->getSet()->size();
-    if (!this->getSet()->empty()){
+    std::vector<Monom*> monoms = this->getMonoms();
+    Monom scratch;
+    int size = monoms.size();
+    if (!monoms.empty()){
         str += start;
         int num = 0;
-        for (std::set<Monom>::iterator it=this->getSet()->begin(); it != this->getSet()->end(); ++it) {
+        for (auto& elem: monoms) {
 
-        	tmp = monToStringWithPhases(*it);
+        	tmp = monToStringWithPhases(this->printable(*elem, scratch));
 			str += tmp;
             num += 1;
             if (num != size) str += delim;
@@ -1086,9 +1680,9 @@ std::string Polynom::to_string_with_phases() const {
 }
 
 //***************************************************************************************
-std::string Polynom::monToStringWithPhases(Monom mon) const {
+std::string Polynom::monToStringWithPhases(const Monom& mon) const {
 	std::string s;
-	std::string start = "[" + mon.getFactor().get_str() + "*" , end = "]", delim = "*";
+	std::string start = "[" + mon.factor.get_str() + "*" , end = "]", delim = "*";
     if (mon.getSize() > 0){
        	s += start;
        	for (int i = 0; i < mon.getSize(); i++){
@@ -1111,40 +1705,40 @@ std::string Polynom::monToStringWithPhases(Monom mon) const {
 
 //***************************************************************************************
 std::string Polynom::to_string_opt() const {
-    std::string start = "", end = "", delimPlus = "+", delimMinus = "-";
-    std::string str;
-    int size = this->getSet()->size();
-    if (!this->getSet()->empty()){
-        str += start;
-        int num = 0;
-        for (std::set<Monom>::iterator it=this->getSet()->begin(); it != this->getSet()->end(); ++it) {
-			str += monToStringOpt(*it);
-            num += 1;
-            if (num != size) {
-            	if ((std::next(it,1))->getFactor() >= 0) str += delimPlus;
-            }
-        }
-    }
-    else{
-        str += "0";
-    }
-    return str;
+	std::string str;
+	this->appendPAC(str);
+	return str;
+}
+
+//***************************************************************************************
+void Polynom::appendPAC(std::string& out) const {
+	std::vector<Monom*> monoms = this->getMonoms();
+	if (monoms.empty()) {
+		out += "0";
+		return;
+	}
+	Monom scratch;
+	for (size_t i = 0; i < monoms.size(); i++) {
+		const Monom& mon = this->printable(*monoms[i], scratch);
+		if (i > 0 && mon.factor.sign() >= 0) out += "+";
+		mon.appendPAC(out);
+	}
 }
 
 //***************************************************************************************
 std::string Polynom::to_string_with_phases_opt() const {
     std::string start = "", end = "", delimPlus = "+", delimMinus = "-";
     std::string str;
-    int size = this->getSet()->size();
-    if (!this->getSet()->empty()){
+    std::vector<Monom*> monoms = this->getMonoms();
+    Monom scratch;
+    if (!monoms.empty()){
         str += start;
         int num = 0;
-        for (std::set<Monom>::iterator it=this->getSet()->begin(); it != this->getSet()->end(); ++it) {
-			str += monToStringWithPhasesOpt(*it);
+        for (auto& elem: monoms) {
+            const Monom& mon = this->printable(*elem, scratch);
+            if (num != 0 && mon.factor.sign() >= 0) str += delimPlus;
+			str += monToStringWithPhasesOpt(mon);
             num += 1;
-            if (num != size) {
-            	if ((std::next(it,1))->getFactor() >= 0) str += delimPlus;
-            }
         }
     }
     else{
@@ -1156,27 +1750,16 @@ std::string Polynom::to_string_with_phases_opt() const {
 }
 
 //***************************************************************************************
-std::string Polynom::monToStringOpt(Monom mon) const {
+std::string Polynom::monToStringOpt(const Monom& mon) const {
 	std::string s;
-	std::string start = mon.getFactor().get_str() , delim = "*";
-    if (mon.getSize() > 0){
-       	s += start;
-       	s += delim;
-       	for (int i = 0; i < mon.getSize(); i++){
-       		s += "x" + std::to_string(mon.vars[i]);
-           	if (i != mon.getSize() - 1) s += delim;
-       	}
-    }
-   	else{
-       	s += start;
-   	}
+	mon.appendPAC(s);
 	return s;
 }
 
 //***************************************************************************************
-std::string Polynom::monToStringWithPhasesOpt(Monom mon) const {
+std::string Polynom::monToStringWithPhasesOpt(const Monom& mon) const {
 	std::string s;
-	std::string start = mon.getFactor().get_str() , delim = "*";
+	std::string start = mon.factor.get_str() , delim = "*";
     if (mon.getSize() > 0){
        	s += start;
        	s += delim;
@@ -1207,67 +1790,247 @@ void Polynom::replace_var_by_negation(std::string& str, varIndex var) {
 
 //***************************************************************************************
 std::vector<Monom> Polynom::modReductionWithQuotient(mpz_class modNum) {
-	std::vector<Monom> toDelete;
+	std::vector<Monom*> toDelete;
 	std::vector<Monom> quotient;
-	for (auto& elem: this->polySet) {
-		mpz_class coefBefore = elem.getFactor();
-		mpz_mod(elem.factor.get_mpz_t(), elem.getFactor().get_mpz_t(), modNum.get_mpz_t());
-		mpz_class coefAfter = elem.getFactor();
-		if (coefBefore == coefAfter) continue;  // In this case no mod reduction was performed.
-		if (coefAfter == 0) toDelete.push_back(elem);  // Mod reduced coef to 0. Remove this monomial.
-		mpz_class diff = coefAfter - coefBefore;
-		mpz_class fact = diff / modNum;
-		quotient.push_back(elem);
-		quotient.back().setFactor(fact);
+	std::vector<Monom*> monoms = this->monomsToReduce(modNum, true);
+	Coef fact;
+	for (auto& elem: monoms) {
+		elem->factor.modWithQuotient(modNum, fact);
+		if (fact.isZero()) continue;  // In this case no mod reduction was performed.
+		if (elem->factor.isZero()) toDelete.push_back(elem);  // Mod reduced coef to 0. Remove this monomial.
+		quotient.push_back(*elem);
+		quotient.back().factor = fact;
 	}
 	for (auto& elem: toDelete) {
-		this->eraseMonom(elem);
+		this->eraseMonom(*elem);
 	}
 	return quotient;
 }
 
 //***************************************************************************************
 std::vector<std::string> Polynom::modReductionWithQuotientStr(mpz_class modNum) {
-	std::vector<Monom> toDelete;
+	std::vector<Monom*> toDelete;
 	std::vector<std::string> quotientStrVec;
-	for (auto& elem: this->polySet) {
-		mpz_class coefBefore = elem.getFactor();
-		mpz_mod(elem.factor.get_mpz_t(), elem.getFactor().get_mpz_t(), modNum.get_mpz_t());
-		mpz_class coefAfter = elem.getFactor();
-		if (coefBefore == coefAfter) continue;  // In this case no mod reduction was performed.
-		if (coefAfter == 0) toDelete.push_back(elem);  // Mod reduced coef to 0. Remove this monomial.
-		mpz_class diff = coefAfter - coefBefore;
-		mpz_class fact = diff / modNum;
-		Monom tmpMon = elem;
-		tmpMon.setFactor(fact);
+	std::vector<Monom*> monoms = this->monomsToReduce(modNum, true);
+	Coef fact;
+	for (auto& elem: monoms) {
+		elem->factor.modWithQuotient(modNum, fact);
+		if (fact.isZero()) continue;  // In this case no mod reduction was performed.
+		if (elem->factor.isZero()) toDelete.push_back(elem);  // Mod reduced coef to 0. Remove this monomial.
+		Monom tmpMon = *elem;
+		tmpMon.factor = fact;
 		quotientStrVec.push_back(monToStringOpt(tmpMon));
 	}
 	for (auto& elem: toDelete) {
-		this->eraseMonom(elem);
+		this->eraseMonom(*elem);
 	}
 	return quotientStrVec;
 }
 
 //***************************************************************************************
 void Polynom::modReducePoly(mpz_class modNum) {
-	std::vector<Monom> toDelete;
-	for (auto& elem: this->polySet) {
-		mpz_mod(elem.factor.get_mpz_t(), elem.getFactor().get_mpz_t(), modNum.get_mpz_t());
-		if (elem.getFactor() == 0) toDelete.push_back(elem);
+	// Lazily kept coefficients are all dirty, so they are reduced below unless another modulus is used.
+	if (this->lazyModReduction() && modNum != this->coefModReduction) this->normalizeCoefs();
+	bool all = this->beginModReduction(modNum);
+	size_t count = 0;
+	if (all) {
+		count = this->size();
+	} else {
+		for (auto& elem: this->dirtyMonoms) {
+			count += elem.size();
+		}
+	}
+	if (this->shardBits > 0 && count >= POLYNOM_PARALLEL_THRESHOLD) {  // Reduce the shards in parallel.
+		this->concurrentUpdate = true;
+		std::vector<std::thread> threads;
+		for (size_t s = 1; s < this->polyTables.size(); s++) {
+			threads.emplace_back(&Polynom::modReduceShard, this, s, std::cref(modNum), all);
+		}
+		this->modReduceShard(0, modNum, all);
+		for (auto& elem: threads) {
+			elem.join();
+		}
+		this->concurrentUpdate = false;
+		return;
+	}
+	std::vector<Monom*> toDelete;
+	std::vector<Monom*> monoms;
+	if (all) {
+		monoms = this->getMonoms(false);
+	} else {
+		for (size_t s = 0; s < this->dirtyMonoms.size(); s++) {
+			this->takeDirtyMonoms(s, monoms);
+		}
+	}
+	for (auto& elem: monoms) {
+		elem->factor.mod(modNum);
+		if (elem->factor.isZero()) toDelete.push_back(elem);
 	}
 	for (auto& elem: toDelete) {
-		this->eraseMonom(elem);
+		this->eraseMonom(*elem);
 	}
 }
 
+//***************************************************************************************
+void Polynom::modReduceShard(size_t shard, const mpz_class& modNum, bool all) {
+	std::vector<Monom*> monoms;
+	if (all) this->polyTables[shard].collect(monoms);
+	else this->takeDirtyMonoms(shard, monoms);
+	for (auto& elem: monoms) {
+		elem->factor.mod(modNum);
+		if (elem->factor.isZero()) this->eraseMonom(*elem);
+	}
+}
+
+//***************************************************************************************
+bool Polynom::beginModReduction(const mpz_class& modNum) {
+	if (!this->dirtyTracking) return true;
+	bool all = this->allDirty || modNum != this->dirtyModNum;
+	if (all) this->clearDirtyMonoms();
+	this->allDirty = false;
+	this->dirtyModNum = modNum;
+	return all;
+}
+
+//***************************************************************************************
+std::vector<Monom*> Polynom::monomsToReduce(const mpz_class& modNum, bool ordered) {
+	if (this->beginModReduction(modNum)) return this->getMonoms(ordered);
+	std::vector<Monom*> monoms;
+	for (size_t s = 0; s < this->dirtyMonoms.size(); s++) {
+		this->takeDirtyMonoms(s, monoms);
+	}
+	if (ordered) std::sort(monoms.begin(), monoms.end(), lessMonomPointer);
+	return monoms;
+}
+
+//***************************************************************************************
+void Polynom::takeDirtyMonoms(size_t shard, std::vector<Monom*>& monoms) {
+	size_t first = monoms.size();
+	this->dirtyMonoms[shard].collect(monoms);
+	this->dirtyMonoms[shard].clear();
+	for (size_t i = first; i < monoms.size(); i++) {
+		monoms[i]->dirty = false;
+	}
+}
+
+//***************************************************************************************
+void Polynom::clearDirtyMonoms() {
+	std::vector<Monom*> monoms;
+	for (size_t s = 0; s < this->dirtyMonoms.size(); s++) {
+		this->takeDirtyMonoms(s, monoms);
+	}
+}
+
+//***************************************************************************************
+void Polynom::setDirtyTracking(bool mode) {
+	this->clearDirtyMonoms();
+	this->dirtyTracking = mode;
+	this->allDirty = true;
+}
+
+//***************************************************************************************
+bool Polynom::getDirtyTracking() const {
+	return this->dirtyTracking;
+}
+
 //***************************************************************************************
 void Polynom::setModReduction(bool mode) {
+	this->normalizeCoefs();  // Coefficients kept unreduced so far are only known modulo the old settings.
 	this->modReductionEnabled = mode;
+	this->updateCoefMode();
 }
 
 //***************************************************************************************
 void Polynom::setModReductionNumber(mpz_class modNum) {
+	this->normalizeCoefs();
 	this->coefModReduction = modNum;
+	this->updateCoefMode();
+}
+
+//***************************************************************************************
+void Polynom::setFixedWidthCoefficients(bool mode) {
+	this->fixedWidthCoefEnabled = mode;
+	this->updateCoefMode();
+}
+
+//***************************************************************************************
+bool Polynom::getFixedWidthCoefficients() const {
+	return this->wideCoefBits > 0;
+}
+
+//***************************************************************************************
+void Polynom::setLazyModReduction(int bits) {
+	this->normalizeCoefs();
+	this->lazyModBits = std::max(0, bits);
+}
+
+//***************************************************************************************
+int Polynom::getLazyModReduction() const {
+	return this->lazyModBits;
+}
+
+//***************************************************************************************
+void Polynom::updateCoefMode() {
+	mpz_srcptr modNum = this->coefModReduction.get_mpz_t();
+	this->modBits = 0;
+	if (this->modReductionEnabled && mpz_sgn(modNum) > 0 && mpz_popcount(modNum) == 1) this->modBits = mpz_scan1(modNum, 0);
+	int bits = 0;
+	if (this->modReductionEnabled && this->fixedWidthCoefEnabled) bits = Coef::fixedWidthBits(this->coefModReduction);
+	if (bits == this->wideCoefBits) return;
+	this->wideCoefBits = bits;
+	std::vector<Monom*> monoms = this->getMonoms(false);
+	for (auto& elem: monoms) {  // Convert the existing coefficients to the new kind.
+		if (bits > 0) {
+			elem->factor.toFixedWidth();
+			elem->factor.truncate(bits);
+		} else {
+			elem->factor.toInteger();
+		}
+	}
+}
+
+//***************************************************************************************
+void Polynom::adaptCoef(Coef& coef) const {
+	if (this->wideCoefBits > 0) coef.toFixedWidth();
+	else coef.toInteger();
+}
+
+//***************************************************************************************
+void Polynom::reduceCoef(Coef& coef) const {
+	if (this->modBits > 0) coef.truncate(this->modBits);  // Fixed-width coefficients always reduce modulo 2^k.
+	else coef.mod(this->coefModReduction);
+}
+
+//***************************************************************************************
+bool Polynom::settleCoef(Coef& coef) const {
+	if (!this->lazyModReduction()) {
+		this->reduceCoef(coef);
+		return coef.isZero();
+	}
+	if (coef.isZeroModPow2(this->modBits)) return true;
+	if (coef.bitSize() > this->modBits + this->lazyModBits) coef.truncate(this->modBits);
+	return false;
+}
+
+//***************************************************************************************
+void Polynom::normalizeCoefs() {
+	if (!this->lazyModReduction()) return;
+	for (auto& elem: this->polySet) {
+		const_cast<Monom&>(elem).factor.truncate(this->modBits);
+	}
+	std::vector<Monom*> monoms;
+	for (auto& table: this->polyTables) {
+		table.collect(monoms);
+	}
+	for (auto& elem: monoms) {
+		elem->factor.truncate(this->modBits);
+	}
+}
+
+//***************************************************************************************
+void Polynom::negateCoef(Coef& coef) const {
+	coef.neg();
+	if (this->modReductionEnabled) this->settleCoef(coef);  // Never 0, coef was not 0 modulo the reduction number.
 }
 
 //***************************************************************************************
@@ -1275,12 +2038,14 @@ Monom Polynom::getShortestModel() {
 	if (this->size() == 0) { std::cout << "Polynomial is empty. No model found." << std::endl; return Monom(); }
 	int minSize = INT_MAX;
 	Monom* monP = NULL;
-	for (auto& elem: this->polySet) {
-		if (elem.size < minSize)  {
-			monP = const_cast<Monom*>(&elem);
-			minSize = elem.size;
+	std::vector<Monom*> monoms = this->getMonoms();
+	for (auto& elem: monoms) {
+		if (elem->size < minSize)  {
+			monP = elem;
+			minSize = elem->size;
 		}
 	}
+	this->normalizeCoef(monP);
 //	std::cout << "Shortest model of polynomial is: " << std::endl;
 //	std::cout << *monP << std::endl;
 	return *monP;
@@ -1288,7 +2053,8 @@ Monom Polynom::getShortestModel() {
 
 //***************************************************************************************
 std::pair<std::string, std::string> Polynom::writeOutStartingPoly() {
-	std::string startpoly = this->to_string();
+	this->normalizeCoefs();
+	std::string startpoly = this->to_string_opt();
 	std::string modNumberStr = this->coefModReduction.get_str();
 	return {startpoly, modNumberStr};
 }
@@ -1301,30 +2067,44 @@ void Polynom::setProofGenerationMode(bool mode) {
 //***************************************************************************************
 void Polynom::startProofGeneration(std::string polyFile, std::string proofFile) {
 	this->setProofGenerationMode(true);
-	set_proof_filenames(polyFile, proofFile);
-	writeStartPolyToFile(this->writeOutStartingPoly(), this->getVarSize());
+	delete this->proofSession;
+	this->proofSession = new ProofSession(polyFile, proofFile);
+	this->proofSession->writeStartPoly(this->writeOutStartingPoly(), this->getVarSize());
+}
+
+//***************************************************************************************
+void Polynom::finishProofGeneration() {
+	if (!this->proofSession) return;
+	this->proofSession->writeProof();
+	delete this->proofSession;
+	this->proofSession = NULL;
+	this->setProofGenerationMode(false);
+}
+
+//***************************************************************************************
+ProofSession* Polynom::getProofSession() const {
+	return this->proofSession;
 }
 
 //***************************************************************************************
 std::string Polynom::writeReplacementAxiom(varIndex replace, std::list<Monom>& mons) {
-	std::string returnStr = "-x";
+	std::string returnStr = "-1*x";
 	returnStr.append(std::to_string(replace));
 	for (auto& elem: mons) {
-		if (elem.getFactor() > 0) returnStr.append("+");
-		returnStr.append(this->monToStringOpt(elem)); 
+		if (elem.factor.sign() >= 0) returnStr.append("+");
+		elem.appendPAC(returnStr);
 	}
 	return returnStr;
 }
 
 //***************************************************************************************
 std::string Polynom::writeReplacementAxiom(varIndex replace, std::set<Monom>* mons) {
-	std::string returnStr = "-x";
+	std::string returnStr = "-1*x";
 	returnStr.append(std::to_string(replace));
 	for (auto& elem: *mons) {
-		if (elem.getFactor() > 0) returnStr.append("+");
-		returnStr.append(this->monToStringOpt(elem)); 
+		if (elem.factor.sign() >= 0) returnStr.append("+");
+		elem.appendPAC(returnStr);
 	}
-
 	return returnStr;
 }
 
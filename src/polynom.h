@@ -20,13 +20,49 @@
 #include <vector>
 #include <cassert>
 #include <deque>
+#include <algorithm>
 #include <cstdint>
-#include <regex>
+#include <thread>
+#include <mutex>
+#include <memory>
 
 // Local includes.
+#include "arena.h"
 #include "monom.h"
+#include "monom_scanner.h"
+#include "monom_table.h"
 #include "proof_writer.h"
 
+// Substitutions producing at least this many products are collected, sorted and merged into polySet in one ordered pass
+// instead of being inserted one by one.
+#ifndef POLYNOM_BULK_THRESHOLD
+#define POLYNOM_BULK_THRESHOLD 32
+#endif
+
+// Substitutions producing at least this many products are split across the substitution threads, if more than one is set.
+#ifndef POLYNOM_PARALLEL_THRESHOLD
+#define POLYNOM_PARALLEL_THRESHOLD 4096
+#endif
+
+// GMP coefficients of a polynomial reducing modulo 2^k may grow up to k + POLYNOM_LAZY_MOD_BITS bits before they are reduced.
+#ifndef POLYNOM_LAZY_MOD_BITS
+#define POLYNOM_LAZY_MOD_BITS 64
+#endif
+
+// A polySet based polynomial stops tracking its changed monomials until the next modulo reduction once 1/POLYNOM_DIRTY_RATIO
+// of all monomials changed. Walking polySet in order is cheaper than tracking and sorting that many.
+#ifndef POLYNOM_DIRTY_RATIO
+#define POLYNOM_DIRTY_RATIO 8
+#endif
+
+// Number of locks guarding the refLists while the shards of a sharded polynomial are updated in parallel.
+#ifndef POLYNOM_REFLIST_LOCKS
+#define POLYNOM_REFLIST_LOCKS 64
+#endif
+
+// Set of monomials of a polynomial. Its nodes are allocated from the PolyArena of the polynomial.
+typedef std::set<Monom, std::less<Monom>, ArenaAllocator<Monom> > MonomSet;
+
 class Polynom {
 	
 	friend class Circuit;
@@ -55,6 +91,18 @@ class Polynom {
 		*/
 		Polynom& operator=(const Polynom& old);
 		
+		/** Move constructor. old is left as empty polynomial.
+
+			@param old Polynom to move from
+		*/
+		Polynom(Polynom&& old);
+		
+		/** Move assignment operator. Contents of this and old are exchanged.
+
+			@param old Polynom to move from
+		*/
+		Polynom& operator=(Polynom&& old);
+		
 		/** Destructor. */
 		virtual ~Polynom();
 		
@@ -65,13 +113,20 @@ class Polynom {
 			@param mon Monom
 			@return Monom* pointer to just added monomial
 		*/
-		Monom* addMonom(Monom mon);
+		Monom* addMonom(const Monom& mon);
+		
+		/** Add monomial to the polynomial. If mon is new, it is moved into the polynomial without copying.
+
+			@param mon Monom
+			@return Monom* pointer to just added monomial
+		*/
+		Monom* addMonom(Monom&& mon);
 		
-		/** Erase monomial from the polynomial.
+		/** Erase monomial from the polynomial. mon may be the element of the polynomial itself.
 
 			@param mon Monom
 		*/
-		void eraseMonom(Monom mon);
+		void eraseMonom(const Monom& mon);
 		
 		/** Add reference variable to corresponding refList and monomials' pointers. 
 
@@ -164,6 +219,53 @@ class Polynom {
 		*/
 		void setModReductionNumber(mpz_class modNum);
 		
+		/** Allow or forbid fixed-width coefficients. If allowed (default) and the polynomial reduces modulo 2^k with k <= 128,
+			coefficients are kept as wrapping 128 bit integers instead of GMP integers.
+
+			@param mode bool
+		*/
+		void setFixedWidthCoefficients(bool mode);
+		
+		/** Return whether the coefficients are currently kept as fixed-width integers.
+
+			@return bool
+		*/
+		bool getFixedWidthCoefficients() const;
+		
+		/** Set by how many bits GMP coefficients may exceed a modulus 2^k before they are reduced. Zero tests are done modulo 2^k,
+			so cancellations are still detected immediately. The lookup functions (findExact, findContaining, ...) reduce the monomials they return,
+			the printing functions print reduced coefficients and everything else is reduced by modReducePoly or normalizeCoefs. 0 reduces after every change, like it is always done for fixed-width coefficients and moduli which are no power of two.
+
+			@param bits int
+		*/
+		void setLazyModReduction(int bits);
+		
+		/** Return by how many bits coefficients may exceed a modulus 2^k before they are reduced, 0 if they are reduced after every change.
+
+			@return int
+		*/
+		int getLazyModReduction() const;
+		
+		/** Reduce all coefficients kept unreduced by the lazy modulo reduction. The printing functions always print reduced coefficients,
+			this is only needed before reading the coefficients of the monomials returned by getMonoms or getSet.
+			Done by the setters of the modulo reduction, modReducePoly, multiplyPoly and at the end of reduce_poly.
+		*/
+		void normalizeCoefs();
+		
+		/** Track the monomials changed since the last modulo reduction, so that modReducePoly and modReductionWithQuotient(Str)
+			only visit those instead of the whole polynomial. Enabling the tracking marks all monomials as changed.
+			Coefficients changed directly through returned monomial pointers are not tracked.
+
+			@param mode bool
+		*/
+		void setDirtyTracking(bool mode);
+		
+		/** Return whether the monomials changed since the last modulo reduction are tracked.
+
+			@return bool
+		*/
+		bool getDirtyTracking() const;
+		
 		/** Reduce all monomial coefficients by modNum.
 
 			@param modNum mpz_class
@@ -387,6 +489,13 @@ class Polynom {
 		*/
 		void replaceVar(varIndex replace, std::set<Monom>* mons);
 		
+		/** Replace variable "replace" by the monomial set of another polynomial.  
+
+			@param replace varIndex variable to replace
+			@param mons MonomSet
+		*/
+		void replaceVar(varIndex replace, const MonomSet* mons);
+		
 		/** Replace variable "replace" by a polynomial.  
 
 			@param replace varIndex variable to replace
@@ -471,11 +580,61 @@ class Polynom {
 		
 		//************************ Getters and Setters.  ***************************************//
 		
-		/** Get a pointer to the set of monomials.  
+		/** Get a pointer to the set of monomials. With the hash backend an ordered copy of all monomials is built 
+			on every call, which stays valid until the next call.
 
-			@return std::set<Monom>*
+			@return MonomSet*
 		*/
-		const std::set<Monom>* getSet() const;
+		const MonomSet* getSet() const;
+		
+		/** Get pointers to all monomials of the polynomial. With the lazy modulo reduction coefficients may be unreduced,
+			call normalizeCoefs first if they are compared (see setLazyModReduction).
+
+			@param ordered bool if true, pointers are sorted like the monomials in the set (always the case for the tree backend)
+			@return std::vector<Monom*>
+		*/
+		std::vector<Monom*> getMonoms(bool ordered = true) const;
+		
+		/** Select the container for the monomials: open addressing hash table if true, ordered set (default) if false.
+			Contained monomials are moved into the new container.
+
+			@param mode bool
+		*/
+		void setHashBackend(bool mode);
+		
+		/** Return whether monomials are kept in the hash table.
+
+			@return bool
+		*/
+		bool getHashBackend() const;
+		
+		/** Set the number of threads used by large substitutions in replaceVar. The occurrences of the replaced variable are
+			partitioned across the threads, the products are merged single threaded, so the result does not depend on the number of threads.
+			A value <= 0 selects the number of hardware threads. Default is 1.
+
+			@param threads int
+		*/
+		void setSubstitutionThreads(int threads);
+		
+		/** Return the number of threads used by large substitutions.
+
+			@return int
+		*/
+		int getSubstitutionThreads() const;
+		
+		/** Split the monomials into the given number of hash shards (rounded up to a power of two), each with its own table and arena.
+			Large substitutions in replaceVar and replaceVarByPoly, multiplyPoly and modReducePoly then update all shards in parallel,
+			one thread per shard. Implies the hash backend. A value <= 1 switches sharding off. Contained monomials are moved.
+
+			@param shards int
+		*/
+		void setShards(int shards);
+		
+		/** Return the number of shards, 1 if the polynomial is not sharded.
+
+			@return int
+		*/
+		int getShards() const;
 		
 		/** Get a pointer to the beginning of RefList.  
 
@@ -529,6 +688,12 @@ class Polynom {
 		*/
 		std::string to_string_opt() const;
 		
+		/** Append the polynomial in PAC syntax to out, e.g. "3*x1*x2-x3" is written as "3*x1*x2-1*x3". The empty polynomial is written as "0".
+
+			@param out std::string
+		*/
+		void appendPAC(std::string& out) const;
+		
 		/** Return string of the polynomial, in reverse order.
 
 			@return std::string
@@ -559,19 +724,19 @@ class Polynom {
 
 			@return std::string
 		*/
-		std::string monToStringWithPhases(Monom mon) const;
+		std::string monToStringWithPhases(const Monom& mon) const;
 		
 		/** Return string of monomial.
 
 			@return std::string
 		*/
-		std::string monToStringOpt(Monom mon) const;
+		std::string monToStringOpt(const Monom& mon) const;
 		
 		/** Return string of monomial, indicating positive phases of variables by "x" and negative phases of variables by "f".
 
 			@return std::string
 		*/
-		std::string monToStringWithPhasesOpt(Monom mon) const;
+		std::string monToStringWithPhasesOpt(const Monom& mon) const;
 		
 		//*********************** Other helper functions.  ******************************************************//
 		
@@ -602,7 +767,7 @@ class Polynom {
 		
 		/** Returns strings for the current polynomial and the modulo coefficient used for modulo reduction (if set).  
 
-			@param std::pair<std::string, std::string> first string is current polynomial, second string is modulo reduction coefficient
+			@param std::pair<std::string, std::string> first string is current polynomial in PAC syntax, second string is modulo reduction coefficient
 		*/
 		std::pair<std::string, std::string> writeOutStartingPoly();
 		
@@ -619,14 +784,25 @@ class Polynom {
 		*/
 		void startProofGeneration(std::string polyFile, std::string proofFile);	
 		
-		/** Helper function to convert substitution step into a PAC proof axiom.  
+		/** Finish proof generation by writing the PAC proof steps for all substitutions since startProofGeneration into the proof file.
+			Ends proof generation.
+		*/
+		void finishProofGeneration();
+		
+		/** Get the proof session of the polynomial, NULL if no proof is generated.
+
+			@return ProofSession*
+		*/
+		ProofSession* getProofSession() const;
+		
+		/** Helper function to convert substitution step into a PAC proof axiom, written in PAC syntax.  
 
 			@param replace varIndex
 			@param mons std::list<Monom>
 		*/
 		std::string writeReplacementAxiom(varIndex replace, std::list<Monom>& mons);
 		
-		/** Helper function to convert substitution step into a PAC proof axiom.  
+		/** Helper function to convert substitution step into a PAC proof axiom, written in PAC syntax.  
 
 			@param replace varIndex
 			@param mons std::set<Monom>
@@ -634,8 +810,345 @@ class Polynom {
 		std::string writeReplacementAxiom(varIndex replace, std::set<Monom>* mons);
 
 	private:
+		/** Create array of reference lists whose elements are taken from the arena.
+
+			@param size size_t number of lists
+			@return MyList*
+		*/
+		MyList* newRefList(size_t size);
+		
+		/** Move variable and pointer arrays of a newly inserted long monomial into the arena.
+
+			@param mon Monom element of polySet
+		*/
+		void adoptMonomStorage(Monom& mon);
+		
+		/** Give arena owned variable and pointer arrays of a monomial back to the arena before it is erased.
+
+			@param mon Monom element of polySet
+		*/
+		void releaseMonomStorage(Monom& mon);
+		
+		/** Move mon into the arena of its shard for storing it in polyTables.
+
+			@param mon Monom
+			@return Monom* the copy
+		*/
+		Monom* newTableMonom(Monom&& mon);
+		
+		/** Destroy a monomial created by newTableMonom and give its memory back to the arena.
+
+			@param mon Monom*
+		*/
+		void deleteTableMonom(Monom* mon);
+		
+		/** Remove all monomials from polySet and polyTables. The refLists are not touched. */
+		void clearMonoms();
+		
+		/** Substitution kernel of replaceVar: replace variable "replace" by the sum of the tail monomials.
+			The replaced variable is stripped once per monomial and every product is built in a reusable scratch monomial,
+			which is only copied into the polynomial if it does not cancel or collide with an existing monomial.
+
+			@param replace varIndex variable to replace
+			@param tail std::vector<const Monom*>
+		*/
+		void substitute(varIndex replace, const std::vector<const Monom*>& tail);
+		
+		// Product of an old monomial and a tail monomial collected by substituteBulk. Its variables are stored in the pool
+		// of its ProductBuffer starting at offset.
+		struct SubstProduct {
+			size_t offset;
+			int size;
+			int sum;
+			uint64_t hashKey;
+			Coef factor;
+		};
+		
+		// Products computed by one worker of substituteBulk. For a sharded polynomial the products are grouped by shard,
+		// the products of shard s are products[shardBegin[s], shardBegin[s + 1]).
+		struct ProductBuffer {
+			std::vector<varIndex> pool;
+			std::vector<SubstProduct> products;
+			std::vector<size_t> shardBegin;
+			int maxSize = 0;
+		};
+		
+		/** Bulk variant of substitute: the products are computed by the worker threads into separate buffers, sorted and combined,
+			then merged into the polynomial and the refLists in a single ordered pass.
+
+			@param replace varIndex variable to replace
+			@param tail std::vector<const Monom*>
+			@param workers int number of threads
+		*/
+		void substituteBulk(varIndex replace, const std::vector<const Monom*>& tail, int workers);
+		
+		/** Compute the products of oldMons with the tail by collectProducts, one thread per buffer.
+			Every thread takes a contiguous range of oldMons.
+
+			@param oldMons std::vector<const Monom*>
+			@param tail std::vector<const Monom*>
+			@param replace varIndex variable to strip from oldMons, -1 for none
+			@param shardBits int shard bits of the target polynomial, 0 if it is not sharded
+			@param buffers std::vector<ProductBuffer>
+		*/
+		static void collectParallel(const std::vector<const Monom*>& oldMons, const std::vector<const Monom*>& tail, varIndex replace, int shardBits, std::vector<ProductBuffer>& buffers);
+		
+		/** Erase oldMons and merge the collected products into a sharded polynomial, one thread per shard.
+			The references of new monomials are added afterwards in the order of Monom::operator<.
+
+			@param oldMons std::vector<const Monom*> monomials to erase
+			@param buffers std::vector<ProductBuffer>
+		*/
+		void mergeSharded(const std::vector<const Monom*>& oldMons, std::vector<ProductBuffer>& buffers);
+		
+		/** Work of one thread of mergeSharded: erase oldMons, which all belong to the given shard, and merge the runs of the shard
+			in the buffers.
+			New monomials are appended to inserted without references.
+
+			@param shard size_t
+			@param oldMons std::vector<const Monom*>
+			@param buffers std::vector<ProductBuffer>
+			@param inserted std::vector<Monom*>
+		*/
+		void mergeShard(size_t shard, const std::vector<const Monom*>& oldMons, std::vector<ProductBuffer>& buffers, std::vector<Monom*>& inserted);
+		
+		/** Reduce the coefficients of one shard by modNum and erase the monomials becoming 0.
+			Only the changed monomials of the shard are visited unless all is set.
+
+			@param shard size_t
+			@param modNum const mpz_class&
+			@param all bool
+		*/
+		void modReduceShard(size_t shard, const mpz_class& modNum, bool all);
+		
+		/** Start a modulo reduction by modNum. Return whether all monomials have to be visited, i.e. the changes are not tracked,
+			everything changed or the last reduction used another modulus. Afterwards new changes are tracked.
+
+			@param modNum const mpz_class&
+			@return bool
+		*/
+		bool beginModReduction(const mpz_class& modNum);
+		
+		/** Start a modulo reduction by modNum and return the monomials it has to visit: the changed ones if they are tracked,
+			otherwise all of them. Ordered by Monom::operator< if ordered is set.
+
+			@param modNum const mpz_class&
+			@param ordered bool
+			@return std::vector<Monom*>
+		*/
+		std::vector<Monom*> monomsToReduce(const mpz_class& modNum, bool ordered);
+		
+		/** Move the changed monomials of a shard into monoms and clear its dirty set.
+
+			@param shard size_t
+			@param monoms std::vector<Monom*>&
+		*/
+		void takeDirtyMonoms(size_t shard, std::vector<Monom*>& monoms);
+		
+		/** Reset the flags of the dirty monomials of all shards and clear their dirty sets. */
+		void clearDirtyMonoms();
+		
+		/** Remember mon as changed since the last modulo reduction. Only touches the dirty set of the shard of mon,
+			so the shards can be updated in parallel. polySet based polynomials fall back to allDirty, see POLYNOM_DIRTY_RATIO.
+
+			@param mon Monom*
+		*/
+		void markDirty(Monom* mon) {
+			if (!this->dirtyTracking || this->allDirty || mon->dirty) return;
+			mon->dirty = true;
+			MonomTable& dirty = this->dirtyMonoms[this->shardOf(mon->hashKey)];
+			dirty.insert(mon);
+			if (!this->hashBackend && dirty.size() * POLYNOM_DIRTY_RATIO >= this->polySet.size()) {
+				this->clearDirtyMonoms();
+				this->allDirty = true;
+			}
+		}
+
+		
+		/** Move all monomials into a new container: hash tables with 2^bits shards if hash is set, polySet otherwise.
+
+			@param hash bool
+			@param bits int
+		*/
+		void rebuildContainer(bool hash, int bits);
+		
+		/** Create the tables, arenas and locks for 2^bits shards. The polynomial has to be empty.
+
+			@param bits int
+		*/
+		void setupShards(int bits);
+		
+		/** Release all monomial storage of the arena and the shard arenas at once. */
+		void resetArenas();
+		
+		/** Return the shard of a monomial with the given hash. The upper bits select the shard, the lower ones the slot in its table.
+
+			@param hash uint64_t
+			@return size_t
+		*/
+		size_t shardOf(uint64_t hash) const { return (this->shardBits == 0) ? 0 : (size_t)(hash >> (64 - this->shardBits)); }
+		
+		/** Return the hash table holding mon.
+
+			@param mon Monom
+			@return MonomTable&
+		*/
+		MonomTable& tableOf(const Monom& mon) { return this->polyTables[this->shardOf(mon.hashKey)]; }
+		
+		/** Return the arena holding the storage and the refList elements of mon.
+
+			@param mon Monom
+			@return PolyArena*
+		*/
+		PolyArena* arenaOf(const Monom& mon) const {
+			size_t shard = this->shardOf(mon.hashKey);
+			return (shard == 0) ? this->arena.get() : this->shardArenas[shard - 1];
+		}
+		
+		/** Compute the products of oldMons[begin, end) with the tail into buf, sort them and combine equal products.
+			If shardBits is set, the products are sorted by shard first and buf.shardBegin marks the run of every shard.
+			Only reads the monomials, so disjoint ranges can be processed concurrently.
+
+			@param oldMons std::vector<const Monom*> monomials containing replace
+			@param begin size_t
+			@param end size_t
+			@param tail std::vector<const Monom*>
+			@param replace varIndex
+			@param shardBits int
+			@param buf ProductBuffer
+		*/
+		static void collectProducts(const std::vector<const Monom*>& oldMons, size_t begin, size_t end, const std::vector<const Monom*>& tail, varIndex replace, int shardBits, ProductBuffer& buf);
+		
+		/** Three-way comparison of two collected products in the order of Monom::operator<.
+
+			@param a SubstProduct
+			@param aVars varIndex* pool of a
+			@param b SubstProduct
+			@param bVars varIndex* pool of b
+			@return int negative, 0 or positive
+		*/
+		static int compareProducts(const SubstProduct& a, const varIndex* aVars, const SubstProduct& b, const varIndex* bVars);
+		
+		/** Add mon to polySet. pos has to be the lower bound of mon in polySet and is advanced behind mon.
+
+			@param mon Monom
+			@param pos MonomSet::iterator
+			@return Monom* pointer to just added monomial
+		*/
+		Monom* addMonomAt(Monom&& mon, MonomSet::iterator& pos);
+		
+		/** Finish adding a monomial: add coef to an existing target or register the references of an inserted target,
+			then apply the modulo reduction. Erases target if its coefficient becomes 0.
+
+			@param target Monom*
+			@param inserted bool
+			@param coef Coef coefficient to add if target already existed
+			@return Monom* target or NULL if erased
+		*/
+		Monom* settleMonom(Monom* target, bool inserted, const Coef& coef);
+		
+		/** Exchange all contents, including the arenas, with other.
+
+			@param other Polynom
+		*/
+		void swapContents(Polynom& other);
+		
+		/** Recompute wideCoefBits from the mod reduction settings and convert all coefficients accordingly. */
+		void updateCoefMode();
+		
+		/** Convert a coefficient to the kind used by this polynomial (fixed-width or integer).
+
+			@param coef Coef
+		*/
+		void adaptCoef(Coef& coef) const;
+		
+		/** Apply the modulo reduction to a changed coefficient, only reducing it if it grew too large for the lazy reduction.
+			Return whether it is 0 modulo the reduction number.
+
+			@param coef Coef
+			@return bool
+		*/
+		bool settleCoef(Coef& coef) const;
+		
+		/** Return whether coefficients are reduced lazily. Only done for GMP coefficients and a modulus 2^k,
+			truncating fixed-width coefficients is already as cheap as testing them.
+
+			@return bool
+		*/
+		bool lazyModReduction() const {
+			return this->modReductionEnabled && this->modBits > 0 && this->lazyModBits > 0 && this->wideCoefBits == 0;
+		}
+		
+		/** Reduce the coefficient of mon if it was kept unreduced by the lazy modulo reduction.
+
+			@param mon Monom* may be NULL
+			@return Monom* mon
+		*/
+		Monom* normalizeCoef(Monom* mon) {
+			if (mon != NULL && this->lazyModReduction()) mon->factor.truncate(this->modBits);
+			return mon;
+		}
+		
+		/** Return a copy of mon with the coefficient reduced like normalizeCoef does. Used to copy monomials out of a const polynomial.
+
+			@param mon Monom
+			@return Monom
+		*/
+		Monom reducedCopy(const Monom& mon) const {
+			Monom copy(mon);
+			if (this->lazyModReduction()) copy.factor.truncate(this->modBits);
+			return copy;
+		}
+		
+		/** Return mon for printing. If the lazy modulo reduction may have left its coefficient unreduced, a reduced copy is built in scratch.
+
+			@param mon Monom
+			@param scratch Monom
+			@return Monom
+		*/
+		const Monom& printable(const Monom& mon, Monom& scratch) const {
+			if (!this->lazyModReduction()) return mon;
+			scratch = mon;
+			scratch.factor.truncate(this->modBits);
+			return scratch;
+		}
+		
+		/** Reduce a coefficient by the modulo reduction number.
+
+			@param coef Coef
+		*/
+		void reduceCoef(Coef& coef) const;
+		
+		/** Negate a coefficient. With modulo reduction the result is reduced like every other changed coefficient,
+			so both backends print the same representative independent of the order the monomials are visited in.
+
+			@param coef Coef
+		*/
+		void negateCoef(Coef& coef) const;
+		
+		// Arena owning the nodes of polySet, the arrays of long monomials and the elements of all refLists. 
+		// Declared before polySet and setSnapshot, since they use it, so it is destroyed after them.
+		std::unique_ptr<PolyArena> arena;
+		
 		// Polynomial consists of two data structures: 1) Set of all monomials  2) List of all reference to monomials for every variable.
-		std::set<Monom> polySet;
+		// The monomials are either kept in the ordered set polySet or, if hashBackend is set, in the hash tables polyTables.
+		// Without sharding there is exactly one table.
+		MonomSet polySet;
+		std::vector<MonomTable> polyTables = std::vector<MonomTable>(1);
+		bool hashBackend = false;
+		
+		// Sharding helpers. Shard 0 uses arena, shard i > 0 uses shardArenas[i-1]. While concurrentUpdate is set,
+		// the shards are changed by parallel threads and removing refList elements takes the lock refListLocks[var % POLYNOM_REFLIST_LOCKS].
+		int shardBits = 0;
+		std::vector<PolyArena*> shardArenas;
+		std::mutex* refListLocks = NULL;
+		bool concurrentUpdate = false;
+		
+		// Number of threads used by large substitutions.
+		int substitutionThreads = 1;
+		
+		// Ordered copy of polyTables handed out by getSet() for the hash backend.
+		mutable MonomSet setSnapshot;
 		MyList* refList;
 		
 		// Helping variable for remembering the variable range of polynomial. Only variables until varSize can be saved in the polynomial.
@@ -648,8 +1161,27 @@ class Polynom {
 		bool modReductionEnabled = false;
 		mpz_class coefModReduction = 0;
 		
+		// Dirty tracking helpers. dirtyMonoms holds the monomials changed since the last modulo reduction by dirtyModNum, one table per shard.
+		// While allDirty is set, every monomial counts as changed and the tables stay empty.
+		bool dirtyTracking = false;
+		bool allDirty = true;
+		mpz_class dirtyModNum = 0;
+		std::vector<MonomTable> dirtyMonoms = std::vector<MonomTable>(1);
+
+		// Lazy modulo reduction helpers. modBits is k if coefficients are reduced modulo 2^k, otherwise 0. lazyModBits is the
+		// number of bits coefficients may grow beyond k before they are reduced.
+		int modBits = 0;
+		int lazyModBits = POLYNOM_LAZY_MOD_BITS;
+
+		// Fixed-width coefficient helpers. wideCoefBits is k if coefficients are kept modulo 2^k in fixed-width form, otherwise 0.
+		bool fixedWidthCoefEnabled = true;
+		int wideCoefBits = 0;
+		
 		// Activating/deactivating proof writing.
 		bool proofEnabled = false;
+		
+		// Files and counters of the proof, owned by the polynomial. Not copied with the polynomial.
+		ProofSession* proofSession = NULL;
 };
 
 #endif /* POLYNOM_H_ */
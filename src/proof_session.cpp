@@ -0,0 +1,219 @@
+/*------------------------------------------------------------------------*/
+/*! \file proof_session.cpp
+    \brief contains the state of one PAC proof generation.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+
+#include "mapped_file.h"
+#include "monom_scanner.h"
+#include "polynom.h"
+#include "proof_session.h"
+
+// All living sessions, used to find the sessions writing a given axiom file.
+static std::mutex sessionsLock;
+static std::vector<ProofSession*> sessions;
+
+//***************************************************************************************
+ProofSession::ProofSession(const std::string& polyFile, const std::string& proofFile) {
+	this->polyFilename = polyFile;
+	this->proofFilename = proofFile;
+	this->axiomNum = 0;
+	this->modCoef = 0;
+	this->firstLine = true;
+	this->lastRemainder = 2;
+	this->pendingSteps = 0;
+	this->stepsPerInference = 1;
+	this->maxInferenceSize = 0;
+	std::lock_guard<std::mutex> guard(sessionsLock);
+	sessions.push_back(this);
+}
+
+//***************************************************************************************
+ProofSession::~ProofSession() {
+	std::lock_guard<std::mutex> guard(sessionsLock);
+	sessions.erase(std::find(sessions.begin(), sessions.end(), this));
+}
+
+//***************************************************************************************
+void ProofSession::checkpointSessions(const std::string& polyFile) {
+	std::lock_guard<std::mutex> guard(sessionsLock);
+	for (auto& elem: sessions) {
+		if (elem->polyFilename == polyFile) elem->polySink.checkpoint();
+	}
+}
+
+//***************************************************************************************
+const std::string& ProofSession::getPolyFilename() const {
+	return this->polyFilename;
+}
+
+//***************************************************************************************
+const std::string& ProofSession::getProofFilename() const {
+	return this->proofFilename;
+}
+
+//***************************************************************************************
+void ProofSession::setStepsPerInference(int steps) {
+	this->stepsPerInference = std::max(steps, 1);
+}
+
+//***************************************************************************************
+int ProofSession::getStepsPerInference() const {
+	return this->stepsPerInference;
+}
+
+//***************************************************************************************
+void ProofSession::setMaxInferenceSize(size_t bytes) {
+	this->maxInferenceSize = bytes;
+}
+
+//***************************************************************************************
+void ProofSession::writeStartPoly(const std::pair<std::string, std::string>& inputpair, int maxVarIndex) {
+	this->axiomNum = 0;
+	this->firstLine = true;
+	this->proofSink.close();
+	if (this->polySink.open(this->polyFilename, false)) { // Create a file for writing first axioms for the PAC proof.
+		this->polySink.write(std::to_string(this->axiomNum++) + " " + std::to_string(maxVarIndex) + ";\n");
+		this->polySink.write(std::to_string(this->axiomNum++) + " " + inputpair.second + ";\n");
+		this->polySink.write(std::to_string(this->axiomNum++) + " " + inputpair.first + ";\n");
+	}
+	std::ofstream outputProof;
+	outputProof.open(this->proofFilename, std::ofstream::trunc);  // Open the file once so contents gets deleted if it already exists.
+}
+
+//***************************************************************************************
+void ProofSession::writeNewPolyAxiom(const std::string& axiomStr) {
+	if (!this->polySink.isOpen()) this->polySink.open(this->polyFilename, true); // Open file for appending axioms for the PAC proof.
+	this->polySink.write(std::to_string(this->axiomNum++) + " " + axiomStr + ";\n");
+}
+
+//***************************************************************************************
+void ProofSession::checkpoint() {
+	this->polySink.checkpoint();
+	this->proofSink.checkpoint();
+}
+
+//***************************************************************************************
+void ProofSession::writeProof() {
+	this->polySink.close();  // All axioms have to be in the file before it is read.
+	{
+		// Proof steps are numbered after the axioms, which are one per line.
+		MappedFile axioms(this->polyFilename);
+		const char* begin = axioms.getData();
+		const char* end = begin + axioms.getLength();
+		this->axiomNum = std::count(begin, end, '\n');
+		if (begin != end && end[-1] != '\n') this->axiomNum++;
+	}
+	this->firstLine = true;
+	this->lastRemainder = 2;
+	this->pendingInference.clear();
+	this->pendingSteps = 0;
+	Polynom pol;
+	this->modCoef = init_spec_from_PAC(pol, this->polyFilename);
+	pol.setDirtyTracking(this->modCoef > 0);  // Every step only reduces the monomials it changed.
+	this->proofSink.open(this->proofFilename, true);
+	this->reducePolyWithProof(pol);
+	this->proofSink.close();
+}
+
+//****************************************************************************************/
+void ProofSession::reducePolyWithProof(Polynom& spec) {
+	std::ifstream infile(this->polyFilename);
+	if (!infile.is_open()) {
+		std::cout << "Error opening file " << this->polyFilename << ". Make sure the filename is correct." << std::endl;
+	}
+	int lineNum = 0;
+	std::string line;
+	unsigned maxSize = 0;
+	while (std::getline(infile, line)) {
+		++lineNum;
+		if (lineNum < 4) continue;
+		removeLineNumAndSemicolon(line);
+		this->reduceByOneLineWithProof(spec, line, lineNum);
+		if (maxSize < spec.size()) maxSize = spec.size();
+		std::cout << "Current step: " << lineNum - 3 << " with poly.size: " << spec.size() << std::endl;
+	}
+	if (this->pendingSteps > 0) this->writeInference(spec);
+	std::cout << "Steps completed." << std::endl;
+	std::cout << "Max. Size was " << maxSize << std::endl;
+}
+
+//****************************************************************************************/
+void ProofSession::reduceByOneLineWithProof(Polynom& spec, const std::string& line, int lineNum) {
+	MonomScanner scanner(line);
+	int leadingVar = 0;
+	std::list<Monom> tail;
+	if (scanner.next()) leadingVar = scanner.getLastVar();
+	while (scanner.next()) {
+		tail.push_back(scanner.toMonom(false));
+	}
+	std::vector<std::string> quotientStrVec;
+	std::vector<Monom> quotient;
+	spec.replaceVarWithQuotients(leadingVar, tail, quotient , quotientStrVec);
+	this->writeOneLineIntoProof(lineNum - 1, spec, quotientStrVec);
+}
+
+//****************************************************************************************/
+void ProofSession::writeOneLineIntoProof(int usedAxiom, Polynom& pol, std::vector<std::string>& quotientStrVec) {
+	// Every step adds usedAxiom times its quotient. The steps are summed up until the remainder is written, which
+	// needs the previous remainder only once: "id % a1 *(q1) + prev + a2 *(q2) + ..., remainder;".
+	std::string& result = this->pendingInference;
+	if (this->pendingSteps > 0) result.append(" + ");
+	result.append(std::to_string(usedAxiom));
+	result.append(" *(");
+	for (size_t i=0; i < quotientStrVec.size(); ++i) {
+		result.append(quotientStrVec[i]);
+		if ((i != quotientStrVec.size() - 1) && (quotientStrVec[i+1][0] != '-')) result.append("+");
+	}
+	result.append(")");
+	if (this->pendingSteps == 0) {
+		result.append(" + ");
+		result.append(std::to_string(this->lastRemainder));
+	}
+	this->pendingSteps++;
+	if (this->modCoef > 0) this->addModReductionStep(pol);
+	if (this->pendingSteps >= this->stepsPerInference || (this->maxInferenceSize > 0 && result.size() >= this->maxInferenceSize)) {
+		this->writeInference(pol);
+	}
+}
+
+//***************************************************************************************
+void ProofSession::addModReductionStep(Polynom& poly) {
+	std::string multAxiom = "1";
+	std::vector<std::string> quotientStrVec = poly.modReductionWithQuotientStr(this->modCoef);
+	if (quotientStrVec.empty()) return;
+	std::string& result = this->pendingInference;
+	result.append(" + ");
+	result.append(multAxiom);
+	result.append(" *(");
+	for (size_t i=0; i < quotientStrVec.size(); ++i) {
+		result.append(quotientStrVec[i]);
+		if ((i != quotientStrVec.size() - 1) && (quotientStrVec[i+1][0] != '-')) result.append("+");
+	}
+	result.append(")");
+}
+
+//***************************************************************************************
+void ProofSession::writeInference(Polynom& poly) {
+	std::string result = std::to_string(this->axiomNum);
+	result.append(" % ");
+	result.append(this->pendingInference);
+	result.append(", ");
+	poly.appendPAC(result);
+	result.append(";\n");
+	// Also write deletion of last remainder since it will not be used anymore. The specification is kept.
+	if (!this->firstLine) result.append(std::to_string(this->lastRemainder) + " d;\n");
+	this->firstLine = false;
+	this->lastRemainder = this->axiomNum++;
+	this->pendingInference.clear();
+	this->pendingSteps = 0;
+	if (!this->proofSink.isOpen()) this->proofSink.open(this->proofFilename, true);
+	this->proofSink.write(result);
+}
@@ -0,0 +1,172 @@
+/*------------------------------------------------------------------------*/
+/*! \file proof_session.h
+    \brief contains the state of one PAC proof generation.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#ifndef PROOF_SESSION_H_
+#define PROOF_SESSION_H_
+
+// std includes.
+#include <stdlib.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmpxx.h>
+
+// Local includes.
+#include "proof_sink.h"
+class Polynom;
+
+// One PAC proof generation, consisting of the file with the starting polynomial and the substitution
+// axioms and the file with the proof steps. Every session has its own axiom counter, modulus and output files,
+// so several polynomials can generate proofs at the same time, each from its own thread.
+// A proof is generated in two phases: first the axioms are recorded while the polynomial is reduced,
+// then writeProof() replays them and writes the proof steps.
+class ProofSession {
+
+	public:
+		//*********************** Constructors  ******************************************************//
+
+		/** Constructor. No file is touched before writeStartPoly or writeProof is called.
+
+			@param polyFile std::string file for the starting polynomial and the substitution axioms
+			@param proofFile std::string file for the PAC proof steps
+		*/
+		ProofSession(const std::string& polyFile, const std::string& proofFile);
+
+		/** Destructor. Closes the files. */
+		virtual ~ProofSession();
+
+		ProofSession(const ProofSession&) = delete;
+		ProofSession& operator=(const ProofSession&) = delete;
+
+		/** Write everything recorded by the sessions writing polyFile to disk.
+
+			@param polyFile std::string
+		*/
+		static void checkpointSessions(const std::string& polyFile);
+
+		//*********************** Getters  ******************************************************//
+
+		/** Get the name of the file with the axioms.
+
+			@return std::string
+		*/
+		const std::string& getPolyFilename() const;
+
+		/** Get the name of the file with the proof steps.
+
+			@return std::string
+		*/
+		const std::string& getProofFilename() const;
+
+		//*********************** Recording axioms  ******************************************************//
+
+		/** Write starting polynomial as well as mod reduction coefficient and max. variable index of polynomial to the axiom file.
+			The proof file is emptied.
+
+			@param inputpair std::pair<std::string, std::string> first is the polynomial in PAC syntax (see Polynom::appendPAC), second is the mod reduction number as string
+			@param maxVarIndex int
+		*/
+		void writeStartPoly(const std::pair<std::string, std::string>& inputpair, int maxVarIndex);
+
+		/** Write the given polynomial in PAC syntax as axiom into the axiom file.
+
+			@param axiomStr std::string
+		*/
+		void writeNewPolyAxiom(const std::string& axiomStr);
+
+		/** Write everything written into both files so far to disk. The files stay open. */
+		void checkpoint();
+
+		//*********************** Writing the proof  ******************************************************//
+
+		/** Combine the given number of consecutive substitution steps into one PAC inference, so the remainder is only written every steps steps.
+			The default 1 writes one inference per step.
+
+			@param steps int
+		*/
+		void setStepsPerInference(int steps);
+
+		/** Get the number of substitution steps combined into one inference.
+
+			@return int
+		*/
+		int getStepsPerInference() const;
+
+		/** Write the remainder early as soon as the combined quotients of the pending steps exceed the given number of bytes. 0 means no limit.
+
+			@param bytes size_t
+		*/
+		void setMaxInferenceSize(size_t bytes);
+
+
+		/** Take the series of polynomial reduction steps recorded in the axiom file and write the complete PAC proof into the proof file. */
+		void writeProof();
+
+		/** Reduce specification polynomial by the reduction steps in the axiom file and write the PAC proof steps.
+
+			@param spec Polynom
+		*/
+		void reducePolyWithProof(Polynom& spec);
+
+		/** Reduce specification polynomial by one line representing a single polynomial reduction step.
+
+			@param spec Polynom
+			@param line std::string
+			@param lineNum int
+		*/
+		void reduceByOneLineWithProof(Polynom& spec, const std::string& line, int lineNum);
+
+		/** Add one step of polynomial reduction to the pending inference and write the inference if enough steps are combined.
+
+			@param usedAxiom int
+			@param pol Polynom
+			@param quotientStrVec std::vector<std::string>
+		*/
+		void writeOneLineIntoProof(int usedAxiom, Polynom& pol, std::vector<std::string>& quotientStrVec);
+
+		/** Reduce the coefficients of poly and add the modulo reduction to the pending inference.
+
+			@param poly Polynom
+		*/
+		void addModReductionStep(Polynom& poly);
+
+		/** Write the pending inference with poly as its conclusion.
+
+			@param poly Polynom
+		*/
+		void writeInference(Polynom& poly);
+
+	private:
+		// Names of the files.
+		std::string polyFilename;
+		std::string proofFilename;
+
+		// Number of the next axiom or proof step.
+		int axiomNum;
+
+		// Modulus of the coefficients, 0 if they are not reduced.
+		mpz_class modCoef;
+
+		// Whether the next proof step is the first one and the number of the last written remainder.
+		bool firstLine;
+		int lastRemainder;
+
+		// Linear combination of the steps not written yet.
+		std::string pendingInference;
+		int pendingSteps;
+		int stepsPerInference;
+		size_t maxInferenceSize;
+
+		// Open output files.
+		ProofSink polySink;
+		ProofSink proofSink;
+};
+
+#endif /* PROOF_SESSION_H_ */
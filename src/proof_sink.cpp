@@ -0,0 +1,118 @@
+/*------------------------------------------------------------------------*/
+/*! \file proof_sink.cpp
+    \brief contains the buffered output file used for writing proofs.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include "proof_sink.h"
+
+// Number of full chunks which may wait for the writing thread before the caller blocks.
+#define PROOF_SINK_MAX_PENDING 4
+
+//***************************************************************************************
+ProofSink::ProofSink(size_t chunkSize) {
+	this->file = NULL;
+	this->chunkSize = chunkSize;
+	this->busy = false;
+	this->stopping = false;
+}
+
+//***************************************************************************************
+ProofSink::~ProofSink() {
+	this->close();
+}
+
+//***************************************************************************************
+bool ProofSink::open(const std::string& filename, bool append) {
+	this->close();
+	this->file = fopen(filename.c_str(), append ? "a" : "w");
+	if (this->file == NULL) return false;
+	this->filename = filename;
+	this->current.reserve(this->chunkSize);
+	this->stopping = false;
+	this->writer = std::thread(&ProofSink::run, this);
+	return true;
+}
+
+//***************************************************************************************
+bool ProofSink::isOpen() const {
+	return this->file != NULL;
+}
+
+//***************************************************************************************
+const std::string& ProofSink::getFilename() const {
+	return this->filename;
+}
+
+//***************************************************************************************
+void ProofSink::checkpoint() {
+	if (!this->file) return;
+	this->submit();
+	std::unique_lock<std::mutex> guard(this->lock);
+	this->wakeCaller.wait(guard, [this]() { return this->pending.empty() && !this->busy; });
+	fflush(this->file);
+}
+
+//***************************************************************************************
+void ProofSink::close() {
+	if (!this->file) return;
+	this->submit();
+	{
+		std::lock_guard<std::mutex> guard(this->lock);
+		this->stopping = true;
+	}
+	this->wakeWriter.notify_one();
+	this->writer.join();
+	fclose(this->file);
+	this->file = NULL;
+	this->filename.clear();
+	this->spare.clear();
+}
+
+//***************************************************************************************
+void ProofSink::write(const std::string& text) {
+	if (!this->file) return;
+	this->current.append(text);
+	if (this->current.size() >= this->chunkSize) this->submit();
+}
+
+//***************************************************************************************
+void ProofSink::submit() {
+	if (this->current.empty()) return;
+	std::unique_lock<std::mutex> guard(this->lock);
+	this->wakeCaller.wait(guard, [this]() { return this->pending.size() < PROOF_SINK_MAX_PENDING; });
+	this->pending.push_back(std::string());
+	this->pending.back().swap(this->current);
+	if (!this->spare.empty()) {  // Continue in a chunk already written, its memory is reused.
+		this->current.swap(this->spare.back());
+		this->spare.pop_back();
+	} else {
+		this->current.reserve(this->chunkSize);
+	}
+	guard.unlock();
+	this->wakeWriter.notify_one();
+}
+
+//***************************************************************************************
+void ProofSink::run() {
+	std::unique_lock<std::mutex> guard(this->lock);
+	while (true) {
+		this->wakeWriter.wait(guard, [this]() { return !this->pending.empty() || this->stopping; });
+		if (this->pending.empty()) break;  // Stopping and everything is written.
+		std::string chunk;
+		chunk.swap(this->pending.front());
+		this->pending.pop_front();
+		this->busy = true;
+		guard.unlock();
+		fwrite(chunk.data(), 1, chunk.size(), this->file);
+		chunk.clear();
+		guard.lock();
+		this->busy = false;
+		this->spare.push_back(std::string());
+		this->spare.back().swap(chunk);
+		this->wakeCaller.notify_all();
+	}
+}
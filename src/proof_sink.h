@@ -0,0 +1,105 @@
+/*------------------------------------------------------------------------*/
+/*! \file proof_sink.h
+    \brief contains the buffered output file used for writing proofs.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#ifndef PROOF_SINK_H_
+#define PROOF_SINK_H_
+
+// std includes.
+#include <stdio.h>
+#include <stdlib.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Output file which stays open while a proof is written. Text is collected in large chunks and
+// full chunks are written by a background thread, so the caller never waits for a system call.
+// The file is only flushed by checkpoint() and close().
+class ProofSink {
+
+	public:
+		//*********************** Constructors  ******************************************************//
+
+		/** Constructor. The sink is not attached to a file yet.
+
+			@param chunkSize size_t number of bytes collected before they are handed to the writing thread
+		*/
+		ProofSink(size_t chunkSize = 1 << 20);
+
+		/** Destructor. Closes the file. */
+		virtual ~ProofSink();
+
+		ProofSink(const ProofSink&) = delete;
+		ProofSink& operator=(const ProofSink&) = delete;
+
+		//*********************** File  ******************************************************//
+
+		/** Open the file, closing the previous one first.
+
+			@param filename std::string
+			@param append bool keep the contents of an existing file
+			@return bool false if the file could not be opened
+		*/
+		bool open(const std::string& filename, bool append);
+
+		/** Return whether a file is open.
+
+			@return bool
+		*/
+		bool isOpen() const;
+
+		/** Get the name of the open file, empty if none is open.
+
+			@return std::string
+		*/
+		const std::string& getFilename() const;
+
+		/** Write all text collected so far into the file and flush it. */
+		void checkpoint();
+
+		/** Write all text collected so far, close the file and stop the writing thread. */
+		void close();
+
+		//*********************** Output  ******************************************************//
+
+		/** Append text. Ignored if no file is open.
+
+			@param text std::string
+		*/
+		void write(const std::string& text);
+
+	private:
+		/** Hand the current chunk to the writing thread, waiting while too many chunks are pending. */
+		void submit();
+
+		/** Main loop of the writing thread. */
+		void run();
+
+		// Open file and its name.
+		FILE* file;
+		std::string filename;
+
+		// Chunk collected by the caller.
+		std::string current;
+		size_t chunkSize;
+
+		// Chunks waiting for the writing thread and written chunks kept for reuse, guarded by lock.
+		std::deque<std::string> pending;
+		std::vector<std::string> spare;
+		bool busy;
+		bool stopping;
+		std::mutex lock;
+		std::condition_variable wakeWriter;
+		std::condition_variable wakeCaller;
+		std::thread writer;
+};
+
+#endif /* PROOF_SINK_H_ */
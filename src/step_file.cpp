@@ -0,0 +1,83 @@
+/*------------------------------------------------------------------------*/
+/*! \file step_file.cpp
+    \brief contains the memory mapped reader for files with a specification
+    polynomial and substitution steps.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include <cstring>
+
+#include "step_file.h"
+
+//***************************************************************************************
+StepFile::StepFile(const std::string& filename) : file(filename) {
+	this->maxVarIndex = 0;
+	this->modulus = 0;
+	this->specBegin = this->specEnd = NULL;
+	this->stepsBegin = this->cursor = NULL;
+	if (!this->file.isOpen()) return;
+	const char* pos = this->file.getData();
+	const char* begin = NULL;
+	const char* end = NULL;
+	if (this->readLine(pos, begin, end)) this->maxVarIndex = std::stoi(std::string(begin, end));
+	if (this->readLine(pos, begin, end)) this->modulus = mpz_class(std::string(begin, end));
+	this->specBegin = this->specEnd = pos;
+	if (this->readLine(pos, begin, end)) {
+		this->specBegin = begin;
+		this->specEnd = end;
+	}
+	this->stepsBegin = this->cursor = pos;
+}
+
+//***************************************************************************************
+StepFile::~StepFile() {
+}
+
+//***************************************************************************************
+bool StepFile::isOpen() const {
+	return this->file.isOpen();
+}
+
+//***************************************************************************************
+const std::string& StepFile::getFilename() const {
+	return this->file.getFilename();
+}
+
+//***************************************************************************************
+int StepFile::getMaxVarIndex() const {
+	return this->maxVarIndex;
+}
+
+//***************************************************************************************
+const mpz_class& StepFile::getModulus() const {
+	return this->modulus;
+}
+
+//***************************************************************************************
+MonomScanner StepFile::getSpec() const {
+	return MonomScanner(this->specBegin, this->specEnd);
+}
+
+//***************************************************************************************
+bool StepFile::nextStep(const char*& begin, const char*& end) {
+	return this->readLine(this->cursor, begin, end);
+}
+
+//***************************************************************************************
+void StepFile::rewind() {
+	this->cursor = this->stepsBegin;
+}
+
+//***************************************************************************************
+bool StepFile::readLine(const char*& pos, const char*& begin, const char*& end) const {
+	const char* fileEnd = this->file.getData() + this->file.getLength();
+	if (pos == NULL || pos >= fileEnd) return false;
+	const char* lineBreak = static_cast<const char*>(std::memchr(pos, '\n', fileEnd - pos));
+	begin = pos;
+	end = (lineBreak == NULL) ? fileEnd : lineBreak;
+	pos = (lineBreak == NULL) ? fileEnd : lineBreak + 1;
+	return true;
+}
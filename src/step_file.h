@@ -0,0 +1,112 @@
+/*------------------------------------------------------------------------*/
+/*! \file step_file.h
+    \brief contains the memory mapped reader for files with a specification
+    polynomial and substitution steps.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#ifndef STEP_FILE_H_
+#define STEP_FILE_H_
+
+// std includes.
+#include <stdlib.h>
+#include <string>
+
+#include <gmpxx.h>
+
+// Local includes.
+#include "mapped_file.h"
+#include "monom_scanner.h"
+
+// Reader for step files (see Benchmarks/benchmark_explanation.txt). The file is mapped into memory once,
+// the header is parsed on opening and the step lines are handed out as pointers into the mapped pages without copying.
+class StepFile {
+
+	public:
+		//*********************** Constructors  ******************************************************//
+
+		/** Constructor. Maps the file and reads the header.
+
+			@param filename std::string
+		*/
+		StepFile(const std::string& filename);
+
+		/** Destructor. */
+		virtual ~StepFile();
+
+		StepFile(const StepFile&) = delete;
+		StepFile& operator=(const StepFile&) = delete;
+
+		//*********************** Header  ******************************************************//
+
+		/** Return whether the file could be opened.
+
+			@return bool
+		*/
+		bool isOpen() const;
+
+		/** Get the name of the file.
+
+			@return std::string
+		*/
+		const std::string& getFilename() const;
+
+		/** Get the maximum variable index given in line 1.
+
+			@return int
+		*/
+		int getMaxVarIndex() const;
+
+		/** Get the modulus given in line 2, 0 if coefficients are not reduced.
+
+			@return mpz_class
+		*/
+		const mpz_class& getModulus() const;
+
+		/** Get a scanner over the specification polynomial in line 3.
+
+			@return MonomScanner
+		*/
+		MonomScanner getSpec() const;
+
+		//*********************** Steps  ******************************************************//
+
+		/** Get the next step line. The line is not copied, begin and end point into the mapped file and stay valid as long as the StepFile.
+
+			@param begin const char*& first character of the line
+			@param end const char*& end of the line, without line break
+			@return bool false if there are no more steps
+		*/
+		bool nextStep(const char*& begin, const char*& end);
+
+		/** Continue with the first step again. */
+		void rewind();
+
+	private:
+		/** Return the line starting at pos and move pos behind its line break.
+
+			@param pos const char*&
+			@param begin const char*&
+			@param end const char*&
+			@return bool false if pos is at the end of the file
+		*/
+		bool readLine(const char*& pos, const char*& begin, const char*& end) const;
+
+		// Contents of the file.
+		MappedFile file;
+
+		// Header.
+		int maxVarIndex;
+		mpz_class modulus;
+		const char* specBegin;
+		const char* specEnd;
+
+		// First step and current position.
+		const char* stepsBegin;
+		const char* cursor;
+};
+
+#endif /* STEP_FILE_H_ */
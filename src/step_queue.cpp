@@ -0,0 +1,65 @@
+/*------------------------------------------------------------------------*/
+/*! \file step_queue.cpp
+    \brief contains the bounded queue handing parsed substitution steps
+    from the parser thread to the reducing thread.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <thread>
+
+#include "step_queue.h"
+
+//***************************************************************************************
+StepQueue::StepQueue(size_t capacity) : head(0), tail(0), closed(false) {
+	size_t size = 1;
+	while (size < capacity) size <<= 1;
+	this->slots.resize(size);
+	this->mask = size - 1;
+}
+
+//***************************************************************************************
+StepQueue::~StepQueue() {
+}
+
+//***************************************************************************************
+void StepQueue::push(varIndex leadingVar, std::list<Monom>& tail) {
+	size_t pos = this->tail.load(std::memory_order_relaxed);
+	unsigned rounds = 0;
+	while (pos - this->head.load(std::memory_order_acquire) == this->slots.size()) backoff(rounds);
+	Slot& slot = this->slots[pos & this->mask];
+	slot.leadingVar = leadingVar;
+	slot.tail.swap(tail);  // The slot was emptied by pop.
+	this->tail.store(pos + 1, std::memory_order_release);
+}
+
+//***************************************************************************************
+void StepQueue::close() {
+	this->closed.store(true, std::memory_order_release);
+}
+
+//***************************************************************************************
+bool StepQueue::pop(varIndex& leadingVar, std::list<Monom>& tail) {
+	tail.clear();
+	size_t pos = this->head.load(std::memory_order_relaxed);
+	unsigned rounds = 0;
+	while (this->tail.load(std::memory_order_acquire) == pos) {
+		// Steps pushed before close are visible once closed is, so check for them again before giving up.
+		if (this->closed.load(std::memory_order_acquire) && this->tail.load(std::memory_order_acquire) == pos) return false;
+		backoff(rounds);
+	}
+	Slot& slot = this->slots[pos & this->mask];
+	leadingVar = slot.leadingVar;
+	tail.swap(slot.tail);
+	this->head.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+//***************************************************************************************
+void StepQueue::backoff(unsigned& rounds) {
+	if (++rounds < 64) std::this_thread::yield();
+	else std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
@@ -0,0 +1,87 @@
+/*------------------------------------------------------------------------*/
+/*! \file step_queue.h
+    \brief contains the bounded queue handing parsed substitution steps
+    from the parser thread to the reducing thread.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#ifndef STEP_QUEUE_H_
+#define STEP_QUEUE_H_
+
+// std includes.
+#include <stdlib.h>
+#include <atomic>
+#include <list>
+#include <vector>
+
+// Local includes.
+#include "monom.h"
+
+// Bounded single-producer/single-consumer ring buffer of substitution steps. Exactly one thread may push and one thread may pop.
+// The monomial lists are swapped in and out of the slots, so no monomial is copied. A full or empty queue is waited for
+// by spinning briefly and then sleeping in short intervals.
+class StepQueue {
+
+	public:
+		//*********************** Constructors  ******************************************************//
+
+		/** Constructor.
+
+			@param capacity size_t number of steps buffered at most, rounded up to a power of two
+		*/
+		StepQueue(size_t capacity = 64);
+
+		/** Destructor. */
+		virtual ~StepQueue();
+
+		StepQueue(const StepQueue&) = delete;
+		StepQueue& operator=(const StepQueue&) = delete;
+
+		//*********************** Producer  ******************************************************//
+
+		/** Append a step, waiting while the queue is full. tail is empty afterwards.
+
+			@param leadingVar varIndex variable which is replaced
+			@param tail std::list<Monom>& replacing monomials
+		*/
+		void push(varIndex leadingVar, std::list<Monom>& tail);
+
+		/** Mark the end of the steps. No step may be pushed afterwards. */
+		void close();
+
+		//*********************** Consumer  ******************************************************//
+
+		/** Take the oldest step, waiting while the queue is empty. The previous content of tail is released.
+
+			@param leadingVar varIndex& variable which is replaced
+			@param tail std::list<Monom>& receives the replacing monomials
+			@return bool false if the queue is closed and all steps are taken
+		*/
+		bool pop(varIndex& leadingVar, std::list<Monom>& tail);
+
+	private:
+		/** Wait a little before checking the queue again.
+
+			@param rounds unsigned& number of times waited so far
+		*/
+		static void backoff(unsigned& rounds);
+
+		// One buffered step.
+		struct Slot {
+			varIndex leadingVar;
+			std::list<Monom> tail;
+		};
+
+		std::vector<Slot> slots;
+		size_t mask;
+
+		// Number of steps taken by the consumer and pushed by the producer, kept on separate cache lines.
+		alignas(64) std::atomic<size_t> head;
+		alignas(64) std::atomic<size_t> tail;
+		alignas(64) std::atomic<bool> closed;
+};
+
+#endif /* STEP_QUEUE_H_ */
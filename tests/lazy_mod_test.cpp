@@ -0,0 +1,77 @@
+/*------------------------------------------------------------------------*/
+/*! \file lazy_mod_test.cpp
+    \brief checks that polynomials reduced with the lazy modulo reduction
+    print the same as with the reduction after every change.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include "polynom.h"
+/*------------------------------------------------------------------------*/
+
+static const int MOD_BITS = 200;  // Above the fixed-width limit, so the coefficients are GMP integers.
+static const int VARS = 24;
+
+/**
+    Spec with coefficients close to 2^MOD_BITS, reduced by substituting every variable above 2 by a
+    full adder like tail, which produces negative and growing coefficients.
+*/
+static void build_and_reduce(Polynom& poly, bool lazy) {
+  mpz_class modNum = mpz_class(1) << MOD_BITS;
+  poly.setModReduction(true);
+  poly.setModReductionNumber(modNum);
+  if (!lazy) poly.setLazyModReduction(0);
+  for (varIndex v = 3; v <= VARS; v++) {
+    Monom mon(v);
+    mon.setFactor(modNum - (mpz_class(1) << (v % 7)) - v);
+    poly.addMonom(mon);
+  }
+  for (varIndex v = VARS; v >= 3; v--) {
+    std::list<Monom> tail;
+    Monom a(v - 1), b(v - 2), ab(v - 2, v - 1);
+    a.setFactor(1);
+    b.setFactor(1);
+    ab.setFactor(-2);
+    tail.push_back(a);
+    tail.push_back(b);
+    tail.push_back(ab);
+    poly.replaceVar(v, tail);
+  }
+}
+
+/**
+    Compare one printing function of both polynomials.
+*/
+static bool same(const std::string& name, const std::string& lazy, const std::string& eager) {
+  if (lazy == eager) return true;
+  std::cerr << name << " differs:\n  lazy:  " << lazy << "\n  eager: " << eager << std::endl;
+  return false;
+}
+
+int main() {
+  Polynom lazy(VARS + 1), eager(VARS + 1);
+  build_and_reduce(lazy, true);
+  build_and_reduce(eager, false);
+
+  // The test is only meaningful if some coefficient is actually kept unreduced.
+  mpz_class modNum = mpz_class(1) << MOD_BITS;
+  bool unreduced = false;
+  for (Monom* mon : lazy.getMonoms()) {
+    mpz_class factor = mon->getFactor();
+    if (factor < 0 || factor >= modNum) unreduced = true;
+  }
+  if (!unreduced) {
+    std::cerr << "no coefficient was kept unreduced" << std::endl;
+    return 1;
+  }
+
+  bool ok = same("to_string", lazy.to_string(), eager.to_string());
+  ok &= same("to_string_reverse", lazy.to_string_reverse(), eager.to_string_reverse());
+  ok &= same("to_string_opt", lazy.to_string_opt(), eager.to_string_opt());
+  ok &= same("to_string_with_phases", lazy.to_string_with_phases(), eager.to_string_with_phases());
+  ok &= same("to_string_with_phases_opt", lazy.to_string_with_phases_opt(), eager.to_string_with_phases_opt());
+  std::cout << (ok ? "lazy_mod_test passed" : "lazy_mod_test FAILED") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,304 @@
+/*------------------------------------------------------------------------*/
+/*! \file fastpoly_bench.cpp
+    \brief runs init_spec and reduce_poly on step files and reports timings,
+    memory and reduction statistics as JSON or CSV.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#ifdef HAVEGETRUSAGE
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+#include "poly_parser.h"
+#include "step_files.h"
+/*------------------------------------------------------------------------*/
+
+// Command line options.
+struct BenchOptions {
+  int reps = 5;
+  int warmup = 1;
+  bool csv = false;
+  bool hash = false;
+  int shards = 1;
+  int threads = 1;
+  std::string output;
+};
+
+// Measurements of one run of init_spec and reduce_poly.
+struct BenchRun {
+  double wall = 0;   // seconds
+  double cpu = 0;    // seconds, all threads
+  size_t rss = 0;    // peak resident set size in bytes
+  ReductionStats stats;
+  size_t finalSize = 0;
+};
+
+// Summary of all measured runs on one file.
+struct BenchResult {
+  std::string file;
+  std::vector<BenchRun> runs;
+  double wallMin = 0, wallMedian = 0, wallMean = 0, wallStddev = 0;
+  double cpuMin = 0, cpuMean = 0;
+  size_t rss = 0;
+};
+
+/*------------------------------------------------------------------------*/
+
+/**
+    CPU time of the process in seconds, summed over all threads.
+*/
+static double cpu_time() {
+#ifdef HAVEGETRUSAGE
+  struct rusage u;
+  if (getrusage(RUSAGE_SELF, &u) == 0) {
+    return u.ru_utime.tv_sec + 1e-6 * u.ru_utime.tv_usec + u.ru_stime.tv_sec + 1e-6 * u.ru_stime.tv_usec;
+  }
+#endif
+  return (double)std::clock() / CLOCKS_PER_SEC;
+}
+
+/**
+    Reset the peak resident set size, so that peak_rss reports the peak of the following run only.
+    Only possible on Linux, elsewhere the peak of the whole process is reported.
+*/
+static void reset_peak_rss() {
+#ifdef __linux__
+  std::ofstream clear("/proc/self/clear_refs");
+  if (clear) clear << "5" << std::flush;
+#endif
+}
+
+/**
+    Peak resident set size in bytes since the last reset_peak_rss, 0 if unknown.
+*/
+static size_t peak_rss() {
+#ifdef __linux__
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) return std::strtoull(line.c_str() + 6, NULL, 10) << 10;
+  }
+#endif
+#ifdef HAVEGETRUSAGE
+  struct rusage u;
+  if (getrusage(RUSAGE_SELF, &u) == 0) return ((size_t)u.ru_maxrss) << 10;
+#endif
+  return 0;
+}
+
+/**
+    Run init_spec and reduce_poly once on the file. The progress output of reduce_poly is suppressed
+    while measuring, so that writing it does not end up in the timings.
+*/
+static BenchRun run_once(const std::string& file, const BenchOptions& options) {
+  BenchRun run;
+  Polynom spec;
+  if (options.hash) spec.setHashBackend(true);
+  if (options.shards > 1) spec.setShards(options.shards);
+  spec.setSubstitutionThreads(options.threads);
+  std::streambuf* out = std::cout.rdbuf(NULL);
+  reset_peak_rss();
+  double cpuStart = cpu_time();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  init_spec(spec, file);
+  reduce_poly(spec, file, &run.stats);
+  std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+  run.cpu = cpu_time() - cpuStart;
+  run.rss = peak_rss();
+  std::cout.rdbuf(out);
+  std::cout.clear();
+  run.wall = std::chrono::duration<double>(stop - start).count();
+  run.finalSize = spec.size();
+  return run;
+}
+
+/**
+    Warm up and measure the file, then summarize the measured runs.
+*/
+static BenchResult bench_file(const std::string& file, const BenchOptions& options) {
+  BenchResult result;
+  result.file = file;
+  for (int i = 0; i < options.warmup; i++) run_once(file, options);
+  for (int i = 0; i < options.reps; i++) {
+    result.runs.push_back(run_once(file, options));
+    std::cerr << file << ": run " << (i + 1) << "/" << options.reps << " " << result.runs.back().wall << " s" << std::endl;
+  }
+  std::vector<double> walls;
+  for (const BenchRun& run : result.runs) {
+    walls.push_back(run.wall);
+    result.wallMean += run.wall;
+    result.cpuMean += run.cpu;
+    result.rss = std::max(result.rss, run.rss);
+  }
+  size_t n = walls.size();
+  std::sort(walls.begin(), walls.end());
+  result.wallMin = walls.front();
+  result.wallMedian = (n % 2 == 1) ? walls[n / 2] : (walls[n / 2 - 1] + walls[n / 2]) / 2;
+  result.wallMean /= n;
+  result.cpuMean /= n;
+  result.cpuMin = result.runs.front().cpu;
+  for (const BenchRun& run : result.runs) {
+    result.cpuMin = std::min(result.cpuMin, run.cpu);
+    result.wallStddev += (run.wall - result.wallMean) * (run.wall - result.wallMean);
+  }
+  result.wallStddev = (n > 1) ? std::sqrt(result.wallStddev / (n - 1)) : 0;
+  return result;
+}
+
+/**
+    Steps per second of the median run.
+*/
+static double steps_per_second(const BenchResult& result) {
+  return (result.wallMedian > 0) ? result.runs.front().stats.steps / result.wallMedian : 0;
+}
+
+/**
+    Quote str as a JSON string.
+*/
+static std::string json_string(const std::string& str) {
+  std::string quoted = "\"";
+  for (char c : str) {
+    if (c == '"' || c == '\\') quoted += '\\';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+/**
+    Write the results as JSON, one object per file with the times of all measured runs.
+*/
+static void write_json(std::ostream& out, const std::vector<BenchResult>& results, const BenchOptions& options) {
+  out << "{\n";
+  out << "  \"reps\": " << options.reps << ",\n";
+  out << "  \"warmup\": " << options.warmup << ",\n";
+  out << "  \"hash\": " << (options.hash ? "true" : "false") << ",\n";
+  out << "  \"shards\": " << options.shards << ",\n";
+  out << "  \"threads\": " << options.threads << ",\n";
+  out << "  \"results\": [";
+  for (size_t i = 0; i < results.size(); i++) {
+    const BenchResult& result = results[i];
+    const BenchRun& first = result.runs.front();
+    out << (i == 0 ? "\n" : ",\n") << "    {\n";
+    out << "      \"file\": " << json_string(result.file) << ",\n";
+    out << "      \"steps\": " << first.stats.steps << ",\n";
+    out << "      \"max_poly_size\": " << first.stats.maxSize << ",\n";
+    out << "      \"final_poly_size\": " << first.finalSize << ",\n";
+    out << "      \"wall_min_s\": " << result.wallMin << ",\n";
+    out << "      \"wall_median_s\": " << result.wallMedian << ",\n";
+    out << "      \"wall_mean_s\": " << result.wallMean << ",\n";
+    out << "      \"wall_stddev_s\": " << result.wallStddev << ",\n";
+    out << "      \"cpu_min_s\": " << result.cpuMin << ",\n";
+    out << "      \"cpu_mean_s\": " << result.cpuMean << ",\n";
+    out << "      \"peak_rss_bytes\": " << result.rss << ",\n";
+    out << "      \"steps_per_s\": " << steps_per_second(result) << ",\n";
+    out << "      \"wall_s\": [";
+    for (size_t j = 0; j < result.runs.size(); j++) out << (j == 0 ? "" : ", ") << result.runs[j].wall;
+    out << "],\n";
+    out << "      \"cpu_s\": [";
+    for (size_t j = 0; j < result.runs.size(); j++) out << (j == 0 ? "" : ", ") << result.runs[j].cpu;
+    out << "]\n";
+    out << "    }";
+  }
+  out << (results.empty() ? "]\n" : "\n  ]\n") << "}" << std::endl;
+}
+
+/**
+    Write the results as CSV, one line per file.
+*/
+static void write_csv(std::ostream& out, const std::vector<BenchResult>& results) {
+  out << "file,steps,max_poly_size,final_poly_size,wall_min_s,wall_median_s,wall_mean_s,wall_stddev_s,cpu_min_s,cpu_mean_s,peak_rss_bytes,steps_per_s" << std::endl;
+  for (const BenchResult& result : results) {
+    const BenchRun& first = result.runs.front();
+    out << result.file << "," << first.stats.steps << "," << first.stats.maxSize << "," << first.finalSize << ","
+        << result.wallMin << "," << result.wallMedian << "," << result.wallMean << "," << result.wallStddev << ","
+        << result.cpuMin << "," << result.cpuMean << "," << result.rss << "," << steps_per_second(result) << std::endl;
+  }
+}
+
+/**
+    Print the command line options.
+*/
+static void usage(const char* name) {
+  std::cerr << "usage: " << name << " [ <option> ... ] <step file or directory> ...\n"
+            << "\n"
+            << "where <option> is one of the following\n"
+            << "\n"
+            << "  -r <n>       measured runs per file (default 5)\n"
+            << "  -w <n>       warm-up runs per file (default 1)\n"
+            << "  -f json|csv  output format (default json)\n"
+            << "  -o <file>    write the results to file instead of stdout\n"
+            << "  --hash       keep the monomials in the hash table\n"
+            << "  --shards <n> split the monomials into n hash shards\n"
+            << "  --threads <n> threads for large substitutions (<= 0: all hardware threads)\n"
+            << "\n"
+            << "Directories are searched for step files (not recursively)." << std::endl;
+}
+
+/**
+    Main Function of the benchmark driver. Usage: fastpoly_bench [ <option> ... ] <step file or directory> ...
+
+*/
+int main(int argc, char ** argv) {
+  BenchOptions options;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = (i + 1 < argc);
+    if (arg == "-h" || arg == "--help") {
+      usage(argv[0]);
+      return 0;
+    } else if (arg == "-r" && hasValue) {
+      options.reps = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "-w" && hasValue) {
+      options.warmup = std::max(0, std::atoi(argv[++i]));
+    } else if (arg == "-f" && hasValue) {
+      std::string format = argv[++i];
+      if (format != "json" && format != "csv") {
+        std::cerr << "invalid format '" << format << "' (try '-h')" << std::endl;
+        return 1;
+      }
+      options.csv = (format == "csv");
+    } else if (arg == "-o" && hasValue) {
+      options.output = argv[++i];
+    } else if (arg == "--hash") {
+      options.hash = true;
+    } else if (arg == "--shards" && hasValue) {
+      options.shards = std::atoi(argv[++i]);
+    } else if (arg == "--threads" && hasValue) {
+      options.threads = std::atoi(argv[++i]);
+    } else if (arg[0] == '-') {
+      std::cerr << "invalid option '" << arg << "' (try '-h')" << std::endl;
+      return 1;
+    } else if (!collect_files(arg, files)) {
+      return 1;
+    }
+  }
+  if (files.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  std::vector<BenchResult> results;
+  for (const std::string& file : files) results.push_back(bench_file(file, options));
+
+  std::ofstream outFile;
+  if (!options.output.empty()) {
+    outFile.open(options.output);
+    if (!outFile) {
+      std::cerr << "Error opening file " << options.output << " for writing." << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& out = options.output.empty() ? std::cout : outFile;
+  if (options.csv) write_csv(out, results);
+  else write_json(out, results, options);
+  return 0;
+}
@@ -0,0 +1,24 @@
+/*------------------------------------------------------------------------*/
+/*! \file fastpoly_convert.cpp
+    \brief converts step files from the text format into the compact
+    binary format.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include "binary_step_file.h"
+/*------------------------------------------------------------------------*/
+
+/**
+    Main Function of the converter. Usage: fastpoly_convert <text step file> <binary step file>
+
+*/
+int main(int argc, char ** argv) {
+  if (argc != 3) {
+    std::cerr << "usage: " << argv[0] << " <text step file> <binary step file>" << std::endl;
+    return 1;
+  }
+  return convertStepFileToBinary(argv[1], argv[2]) ? 0 : 1;
+}
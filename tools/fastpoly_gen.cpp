@@ -0,0 +1,528 @@
+/*------------------------------------------------------------------------*/
+/*! \file fastpoly_gen.cpp
+    \brief generates step files for adders and multipliers of arbitrary
+    bit width and architecture.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gmpxx.h>
+/*------------------------------------------------------------------------*/
+
+// A signal is a variable index > 0 or one of the constants.
+typedef int Signal;
+static const Signal ZERO = 0;
+static const Signal ONE = -1;
+
+// Gate of the circuit, its output is a new variable.
+struct Gate {
+  char type;  // 'a'nd, 'o'r, 'x'or, 'n'ot
+  Signal a, b;
+};
+
+// Gate level circuit. Gates are created in topological order, constant inputs are folded
+// and structurally equal gates are shared.
+class Circuit {
+
+  public:
+    Circuit(int inputs) : inputs(inputs) {}
+
+    Signal input(int index) const { return index + 1; }
+
+    Signal AND(Signal a, Signal b) {
+      if (a == ZERO || b == ZERO) return ZERO;
+      if (a == ONE) return b;
+      if (b == ONE || a == b) return a;
+      return this->gate('a', a, b);
+    }
+
+    Signal OR(Signal a, Signal b) {
+      if (a == ONE || b == ONE) return ONE;
+      if (a == ZERO) return b;
+      if (b == ZERO || a == b) return a;
+      return this->gate('o', a, b);
+    }
+
+    Signal XOR(Signal a, Signal b) {
+      if (a == ZERO) return b;
+      if (b == ZERO) return a;
+      if (a == ONE) return this->NOT(b);
+      if (b == ONE) return this->NOT(a);
+      if (a == b) return ZERO;
+      return this->gate('x', a, b);
+    }
+
+    Signal NOT(Signal a) {
+      if (a == ZERO) return ONE;
+      if (a == ONE) return ZERO;
+      if (this->isGate(a) && this->getGate(a).type == 'n') return this->getGate(a).a;
+      return this->gate('n', a, ZERO);
+    }
+
+    bool isGate(Signal s) const { return s > this->inputs; }
+
+    const Gate& getGate(Signal s) const { return this->gates[s - this->inputs - 1]; }
+
+    int getInputs() const { return this->inputs; }
+
+    int getMaxVar() const { return this->inputs + (int)this->gates.size(); }
+
+  private:
+    Signal gate(char type, Signal a, Signal b) {
+      if (type != 'n' && b < a) std::swap(a, b);
+      std::pair<std::map<std::pair<int, std::pair<int, int>>, Signal>::iterator, bool> it =
+          this->shared.insert(std::make_pair(std::make_pair((int)type, std::make_pair(a, b)), 0));
+      if (it.second) {
+        this->gates.push_back(Gate{type, a, b});
+        it.first->second = this->getMaxVar();
+      }
+      return it.first->second;
+    }
+
+    int inputs;
+    std::vector<Gate> gates;
+    std::map<std::pair<int, std::pair<int, int>>, Signal> shared;
+};
+
+// Rows of a bit matrix, the bit at position i has weight 2^i.
+typedef std::vector<std::vector<Signal>> Rows;
+
+// Bits of equal weight, column i has weight 2^i.
+typedef std::vector<std::vector<Signal>> Columns;
+
+/*------------------------------------------------------------------------*/
+
+/**
+    Full adder, returns the sum and sets carry. Constant inputs turn it into a half adder or less.
+*/
+static Signal full_adder(Circuit& c, Signal a, Signal b, Signal cin, Signal& carry) {
+  Signal t = c.XOR(a, b);
+  carry = c.OR(c.AND(a, b), c.AND(t, cin));
+  return c.XOR(t, cin);
+}
+
+/**
+    Simple partial products, row i holds a_i * b_j at column i + j.
+*/
+static Rows simple_partial_products(Circuit& c, int n, int width) {
+  Rows rows(n, std::vector<Signal>(width, ZERO));
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n && i + j < width; j++) {
+      rows[i][i + j] = c.AND(c.input(i), c.input(n + j));
+    }
+  }
+  return rows;
+}
+
+/**
+    Partial products of radix-4 Booth encoding for unsigned operands, one row per Booth digit, followed by the
+    row of the negation bits. The sign extension of the rows is replaced by inverted sign bits and a constant row,
+    which is correct modulo 2^width.
+*/
+static Rows booth_partial_products(Circuit& c, int n, int width) {
+  Rows rows;
+  std::vector<Signal> negations(width, ZERO);
+  auto a = [&](int i) { return (i >= 0 && i < n) ? c.input(i) : ZERO; };
+  auto b = [&](int j) { return (j >= 0 && j < n) ? c.input(n + j) : ZERO; };
+  mpz_class constant = 0;
+  for (int k = 0; 2 * k <= n; k++) {
+    std::vector<Signal> row(width, ZERO);
+    Signal neg = b(2 * k + 1);
+    Signal one = c.XOR(b(2 * k), b(2 * k - 1));
+    Signal two = c.OR(c.AND(neg, c.NOT(c.OR(b(2 * k), b(2 * k - 1)))), c.AND(c.NOT(neg), c.AND(b(2 * k), b(2 * k - 1))));
+    for (int j = 0; j <= n && 2 * k + j < width; j++) {
+      Signal select = c.OR(c.AND(one, a(j)), c.AND(two, a(j - 1)));
+      row[2 * k + j] = c.XOR(select, neg);
+    }
+    if (n + 1 + 2 * k < width) row[n + 1 + 2 * k] = c.NOT(neg);
+    if (2 * k < width) negations[2 * k] = neg;
+    constant -= mpz_class(1) << (n + 1 + 2 * k);
+    rows.push_back(row);
+  }
+  rows.push_back(negations);
+  mpz_class modulus = mpz_class(1) << width;
+  constant = ((constant % modulus) + modulus) % modulus;
+  std::vector<Signal> constants(width, ZERO);
+  for (int i = 0; i < width; i++) {
+    if (mpz_tstbit(constant.get_mpz_t(), i)) constants[i] = ONE;
+  }
+  rows.push_back(constants);
+  return rows;
+}
+
+/**
+    Bits of the rows sorted into columns.
+*/
+static Columns to_columns(const Rows& rows, int width) {
+  Columns columns(width);
+  for (const std::vector<Signal>& row : rows) {
+    for (int i = 0; i < width; i++) {
+      if (row[i] != ZERO) columns[i].push_back(row[i]);
+    }
+  }
+  return columns;
+}
+
+/**
+    Add bit to column i unless it is 0 or beyond the width.
+*/
+static void push_bit(Columns& columns, size_t i, Signal bit) {
+  if (i < columns.size() && bit != ZERO) columns[i].push_back(bit);
+}
+
+/**
+    Array reduction: the rows are added one after the other by rows of carry save adders.
+*/
+static Columns array_reduction(Circuit& c, const Rows& rows, int width) {
+  std::vector<Signal> sum(width, ZERO);
+  std::vector<Signal> carry(width, ZERO);
+  for (const std::vector<Signal>& row : rows) {
+    std::vector<Signal> nextCarry(width, ZERO);
+    for (int i = 0; i < width; i++) {
+      Signal out;
+      sum[i] = full_adder(c, sum[i], carry[i], row[i], out);
+      if (i + 1 < width) nextCarry[i + 1] = out;
+    }
+    carry = nextCarry;
+  }
+  return to_columns(Rows{sum, carry}, width);
+}
+
+/**
+    Wallace tree: in every stage all columns are compressed by as many full adders as possible and a half adder for
+    two remaining bits, until every column has at most two bits.
+*/
+static Columns wallace_reduction(Circuit& c, Columns columns) {
+  size_t width = columns.size();
+  while (true) {
+    size_t height = 0;
+    for (const std::vector<Signal>& column : columns) height = std::max(height, column.size());
+    if (height <= 2) return columns;
+    Columns next(width);
+    for (size_t i = 0; i < width; i++) {
+      const std::vector<Signal>& bits = columns[i];
+      size_t k = 0;
+      for (; k + 3 <= bits.size(); k += 3) {
+        Signal carry;
+        push_bit(next, i, full_adder(c, bits[k], bits[k + 1], bits[k + 2], carry));
+        push_bit(next, i + 1, carry);
+      }
+      if (k + 2 == bits.size()) {
+        Signal carry;
+        push_bit(next, i, full_adder(c, bits[k], bits[k + 1], ZERO, carry));
+        push_bit(next, i + 1, carry);
+      } else if (k + 1 == bits.size()) {
+        next[i].push_back(bits[k]);
+      }
+    }
+    columns = next;
+  }
+}
+
+/**
+    Dadda tree: the column heights are reduced to the Dadda sequence 2, 3, 4, 6, 9, ... with as few adders as possible.
+*/
+static Columns dadda_reduction(Circuit& c, Columns columns) {
+  size_t width = columns.size();
+  size_t height = 0;
+  for (const std::vector<Signal>& column : columns) height = std::max(height, column.size());
+  std::vector<size_t> targets(1, 2);
+  while (targets.back() * 3 / 2 < height) targets.push_back(targets.back() * 3 / 2);
+  for (size_t t = targets.size(); t-- > 0;) {
+    size_t target = targets[t];
+    Columns next(width);
+    for (size_t i = 0; i < width; i++) {
+      const std::vector<Signal>& bits = columns[i];
+      size_t k = 0;
+      while (bits.size() - k + next[i].size() > target && bits.size() - k >= 2) {
+        bool full = (bits.size() - k + next[i].size() >= target + 2) && bits.size() - k >= 3;
+        Signal carry;
+        Signal sum = full_adder(c, bits[k], bits[k + 1], full ? bits[k + 2] : ZERO, carry);
+        k += full ? 3 : 2;
+        push_bit(next, i, sum);
+        push_bit(next, i + 1, carry);
+      }
+      next[i].insert(next[i].end(), bits.begin() + k, bits.end());
+    }
+    columns = next;
+  }
+  return columns;
+}
+
+/**
+    Ripple carry adder. Returns width sum bits and the carry out.
+*/
+static std::vector<Signal> ripple_carry_adder(Circuit& c, const std::vector<Signal>& a, const std::vector<Signal>& b) {
+  std::vector<Signal> sum;
+  Signal carry = ZERO;
+  for (size_t i = 0; i < a.size(); i++) sum.push_back(full_adder(c, a[i], b[i], carry, carry));
+  sum.push_back(carry);
+  return sum;
+}
+
+/**
+    Parallel prefix adder. network is "ks" (Kogge-Stone), "bk" (Brent-Kung) or "lf" (Ladner-Fischer).
+    Returns width sum bits and the carry out.
+*/
+static std::vector<Signal> prefix_adder(Circuit& c, const std::vector<Signal>& a, const std::vector<Signal>& b, const std::string& network) {
+  size_t width = a.size();
+  std::vector<Signal> p(width), g(width), G(width), P(width);
+  for (size_t i = 0; i < width; i++) {
+    p[i] = P[i] = c.XOR(a[i], b[i]);
+    g[i] = G[i] = c.AND(a[i], b[i]);
+  }
+  // Extend the group [..i] by the group [..j] directly below it.
+  auto combine = [&](size_t i, size_t j) {
+    G[i] = c.OR(G[i], c.AND(P[i], G[j]));
+    P[i] = c.AND(P[i], P[j]);
+  };
+  if (network == "ks") {
+    for (size_t d = 1; d < width; d *= 2) {
+      for (size_t i = width - 1; i >= d; i--) combine(i, i - d);
+    }
+  } else if (network == "lf") {
+    for (size_t l = 0; ((size_t)1 << l) < width; l++) {
+      for (size_t i = 0; i < width; i++) {
+        if ((i >> l) & 1) combine(i, ((i >> l) << l) - 1);
+      }
+    }
+  } else {
+    size_t d = 1;
+    for (; d < width; d *= 2) {
+      for (size_t i = 2 * d - 1; i < width; i += 2 * d) combine(i, i - d);
+    }
+    for (d /= 4; d >= 1; d /= 2) {
+      for (size_t i = 3 * d - 1; i < width; i += 2 * d) combine(i, i - d);
+    }
+  }
+  std::vector<Signal> sum;
+  for (size_t i = 0; i < width; i++) sum.push_back(i == 0 ? p[0] : c.XOR(p[i], G[i - 1]));
+  sum.push_back(width > 0 ? G[width - 1] : ZERO);
+  return sum;
+}
+
+/**
+    Final stage adder for two operands of equal width.
+*/
+static std::vector<Signal> final_adder(Circuit& c, const std::vector<Signal>& a, const std::vector<Signal>& b, const std::string& adder) {
+  if (adder == "rc") return ripple_carry_adder(c, a, b);
+  return prefix_adder(c, a, b, adder);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+    Append the monomial coef*vars to line, vars in ascending order.
+*/
+static void append_monom(std::string& line, const std::string& coef, const std::vector<Signal>& vars) {
+  line += (coef[0] == '-') ? coef : "+" + coef;
+  for (Signal var : vars) {
+    line += "*x";
+    line += std::to_string(var);
+  }
+}
+
+/**
+    Order of the substitution steps for the used gates. With dfs, the gates are ordered depth first from the outputs, least
+    significant output first, so that the cone of every output is replaced before the next one, like in the files of Benchmarks/.
+    Otherwise they are replaced in reverse order of creation, which can keep the polynomials of multipliers with Kogge-Stone and Brent-Kung adders smaller.
+*/
+static std::vector<Signal> step_order(const Circuit& c, const std::vector<Signal>& outputs, const std::vector<bool>& used, bool dfs) {
+  int inputs = c.getInputs();
+  std::vector<Signal> order;
+  if (!dfs) {
+    for (Signal s = c.getMaxVar(); s > inputs; s--) {
+      if (used[s]) order.push_back(s);
+    }
+    return order;
+  }
+  // Iterative post order, the reversed post order is a reverse topological order.
+  std::vector<char> state(c.getMaxVar() + 1, 0);  // 0 unvisited, 1 on the stack, 2 done
+  for (size_t i = 0; i < outputs.size(); i++) {
+    if (outputs[i] <= inputs || state[outputs[i]] != 0) continue;
+    std::vector<Signal> stack(1, outputs[i]);
+    while (!stack.empty()) {
+      Signal s = stack.back();
+      if (state[s] == 0) {
+        state[s] = 1;
+        const Gate& gate = c.getGate(s);
+        if (gate.b > inputs && state[gate.b] == 0) stack.push_back(gate.b);
+        if (gate.a > inputs && state[gate.a] == 0) stack.push_back(gate.a);
+        continue;
+      }
+      stack.pop_back();
+      if (state[s] == 1) {
+        state[s] = 2;
+        order.push_back(s);
+      }
+    }
+  }
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+/**
+    Write the circuit with outputs z and specification sum 2^i z_i - value as step file. value maps the variables
+    of its monomials to their coefficients. Gates not needed for the outputs are dropped and the variables renumbered.
+    dfs selects the order of the steps, see step_order.
+*/
+static bool write_step_file(const std::string& filename, const Circuit& c, const std::vector<Signal>& outputs, const std::map<std::vector<Signal>, mpz_class>& value, bool dfs) {
+  int inputs = c.getInputs();
+  int maxVar = c.getMaxVar();
+  std::vector<bool> used(maxVar + 1, false);
+  for (Signal s : outputs) {
+    if (s > 0) used[s] = true;
+  }
+  for (int s = maxVar; s > inputs; s--) {
+    if (!used[s]) continue;
+    const Gate& gate = c.getGate(s);
+    if (gate.a > 0) used[gate.a] = true;
+    if (gate.b > 0) used[gate.b] = true;
+  }
+  std::vector<Signal> index(maxVar + 1, 0);
+  int vars = 0;
+  for (int s = 1; s <= maxVar; s++) {
+    if (s <= inputs || used[s]) index[s] = ++vars;
+  }
+
+  std::map<std::vector<Signal>, mpz_class> spec = value;
+  for (size_t i = 0; i < outputs.size(); i++) {
+    if (outputs[i] == ZERO) continue;
+    std::vector<Signal> monom;
+    if (outputs[i] != ONE) monom.push_back(index[outputs[i]]);
+    spec[monom] += mpz_class(1) << i;
+  }
+
+  std::ofstream out(filename);
+  if (!out) {
+    std::cerr << "Error opening file " << filename << " for writing." << std::endl;
+    return false;
+  }
+  out << vars << "\n" << (mpz_class(1) << outputs.size()) << "\n";
+  std::string line;
+  for (std::map<std::vector<Signal>, mpz_class>::const_reverse_iterator it = spec.rbegin(); it != spec.rend(); ++it) {
+    if (it->second != 0) append_monom(line, it->second.get_str(), it->first);
+  }
+  out << (line.empty() ? "0" : line) << "\n";
+  // Substitution steps. Every gate is replaced after all gates using it.
+  std::vector<Signal> order = step_order(c, outputs, used, dfs);
+  for (Signal s : order) {
+    const Gate& gate = c.getGate(s);
+    Signal a = index[gate.a];
+    Signal b = (gate.b > 0) ? index[gate.b] : ZERO;
+    line.clear();
+    append_monom(line, "-1", {index[s]});
+    switch (gate.type) {
+      case 'a': append_monom(line, "1", {a, b}); break;
+      case 'o': append_monom(line, "-1", {a, b}); append_monom(line, "1", {a}); append_monom(line, "1", {b}); break;
+      case 'x': append_monom(line, "-2", {a, b}); append_monom(line, "1", {a}); append_monom(line, "1", {b}); break;
+      default: append_monom(line, "-1", {a}); line += "+1"; break;
+    }
+    out << line << "\n";
+  }
+  out.flush();
+  if (!out) {
+    std::cerr << "Error writing file " << filename << "." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/**
+    Print the command line options.
+*/
+static void usage(const char* name) {
+  std::cerr << "usage: " << name << " [ -r ] <architecture> <bits> <step file>\n"
+            << "\n"
+            << "where <architecture> is either an adder <fsa> for two operands of <bits> bits\n"
+            << "or a multiplier <pp>-<tree>-<fsa> for two unsigned operands of <bits> bits with\n"
+            << "\n"
+            << "  <pp>    sp (simple partial products) or bp (radix-4 Booth partial products)\n"
+            << "  <tree>  ar (array), wt (Wallace tree) or dt (Dadda tree)\n"
+            << "  <fsa>   rc (ripple carry), ks (Kogge-Stone), bk (Brent-Kung) or lf (Ladner-Fischer)\n"
+            << "\n"
+            << "The steps are ordered depth first from the outputs, least significant output first.\n"
+            << "With -r they are written in reverse order of construction instead, which can keep the polynomials\n"
+            << "of multipliers with ks and bk adders smaller.\n"
+            << "\n"
+            << "The inputs are x1 ... x<bits> and x<bits+1> ... x<2*bits>, e.g. sp-wt-lf 16 writes a step file\n"
+            << "like Benchmarks/b06_sp-wt-lf_16bit_steps." << std::endl;
+}
+
+/**
+    Main Function of the generator. Usage: fastpoly_gen [ -r ] <architecture> <bits> <step file>
+
+*/
+int main(int argc, char ** argv) {
+  bool dfs = true;
+  int arg = 1;
+  if (arg < argc && std::string(argv[arg]) == "-r") {
+    dfs = false;
+    arg++;
+  }
+  if (argc - arg != 3) {
+    usage(argv[0]);
+    return 1;
+  }
+  std::string architecture = argv[arg];
+  int n = std::atoi(argv[arg + 1]);
+  std::vector<std::string> parts;
+  for (size_t begin = 0, end; begin <= architecture.size(); begin = end + 1) {
+    end = architecture.find('-', begin);
+    if (end == std::string::npos) end = architecture.size();
+    parts.push_back(architecture.substr(begin, end - begin));
+  }
+  std::string adder = parts.back();
+  bool multiplier = (parts.size() == 3);
+  bool valid = (parts.size() == 1 || multiplier) && (adder == "rc" || adder == "ks" || adder == "bk" || adder == "lf");
+  if (multiplier) {
+    valid = valid && (parts[0] == "sp" || parts[0] == "bp") && (parts[1] == "ar" || parts[1] == "wt" || parts[1] == "dt");
+  }
+  if (!valid || n < 1) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  Circuit c(2 * n);
+  std::vector<Signal> outputs;
+  std::map<std::vector<Signal>, mpz_class> value;
+  if (multiplier) {
+    int width = 2 * n;
+    Rows rows = (parts[0] == "sp") ? simple_partial_products(c, n, width) : booth_partial_products(c, n, width);
+    Columns columns;
+    if (parts[1] == "ar") columns = array_reduction(c, rows, width);
+    else if (parts[1] == "wt") columns = wallace_reduction(c, to_columns(rows, width));
+    else columns = dadda_reduction(c, to_columns(rows, width));
+    std::vector<Signal> a(width, ZERO), b(width, ZERO);
+    for (int i = 0; i < width; i++) {
+      if (columns[i].size() > 0) a[i] = columns[i][0];
+      if (columns[i].size() > 1) b[i] = columns[i][1];
+    }
+    outputs = final_adder(c, a, b, adder);
+    outputs.pop_back();  // The product has 2 * bits bits, the carry out is always 0.
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) value[{i + 1, n + j + 1}] -= mpz_class(1) << (i + j);
+    }
+  } else {
+    std::vector<Signal> a, b;
+    for (int i = 0; i < n; i++) {
+      a.push_back(c.input(i));
+      b.push_back(c.input(n + i));
+    }
+    outputs = final_adder(c, a, b, adder);
+    for (int i = 0; i < n; i++) {
+      value[{i + 1}] -= mpz_class(1) << i;
+      value[{n + i + 1}] -= mpz_class(1) << i;
+    }
+  }
+  return write_step_file(argv[arg + 2], c, outputs, value, dfs) ? 0 : 1;
+}
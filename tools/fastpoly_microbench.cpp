@@ -0,0 +1,410 @@
+/*------------------------------------------------------------------------*/
+/*! \file fastpoly_microbench.cpp
+    \brief measures the core kernels of the package in isolation and
+    reports time and heap allocations per operation.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <new>
+#include <random>
+
+#include "poly_parser.h"
+#include "step_files.h"
+/*------------------------------------------------------------------------*/
+
+// Heap allocations of the process: operator new and the allocations of GMP.
+static std::atomic<size_t> allocations(0);
+
+void* operator new(size_t bytes) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(bytes == 0 ? 1 : bytes);
+  if (ptr == NULL) throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](size_t bytes) {
+  return operator new(bytes);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+static void* gmp_allocate(size_t bytes) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(bytes);
+}
+
+static void* gmp_reallocate(void* ptr, size_t, size_t bytes) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return std::realloc(ptr, bytes);
+}
+
+static void gmp_free(void* ptr, size_t) {
+  std::free(ptr);
+}
+
+// Written by the benchmarks so that the measured operations are not optimized away.
+static volatile size_t sink;
+
+/*------------------------------------------------------------------------*/
+
+// Command line options.
+struct MicroOptions {
+  size_t samples = 4096;
+  double minTime = 0.2;
+  unsigned seed = 1;
+  std::string format = "table";
+};
+
+// Inputs of the benchmarks, sampled from step files.
+struct MicroSamples {
+  std::vector<Monom> monoms;  // monomials of the specification halfway through the reduction
+  std::vector<Monom> tails;   // monomials of the substitution steps
+  int maxVar = 0;
+};
+
+// Result of one benchmark.
+struct MicroResult {
+  std::string name;
+  size_t ops = 0;
+  double nsPerOp = 0;
+  double allocsPerOp = 0;
+};
+
+/*------------------------------------------------------------------------*/
+
+/**
+    Append count randomly chosen copies of the monomials to samples.
+*/
+static void sample_monoms(const std::vector<const Monom*>& monoms, size_t count, std::vector<Monom>& samples, std::mt19937& rng) {
+  if (monoms.empty()) return;
+  for (size_t i = 0; i < count; i++) {
+    samples.push_back(*monoms[rng() % monoms.size()]);
+  }
+}
+
+/**
+    Reduce the specification of the file by the first half of its steps and sample the monomials of the
+    specification at that point, where the polynomial is usually largest, and the monomials of all steps.
+*/
+template <typename StepFileType, typename NextStep>
+static void sample_file(StepFileType & file, NextStep nextStep, size_t count, MicroSamples& samples, std::mt19937& rng) {
+  std::vector<varIndex> leadingVars;
+  std::vector<std::list<Monom>> tails;
+  varIndex leadingVar;
+  std::list<Monom> tail;
+  while (nextStep(file, leadingVar, tail)) {
+    leadingVars.push_back(leadingVar);
+    tails.push_back(tail);
+  }
+  Polynom spec;
+  init_spec(spec, file);
+  for (size_t i = 0; i < tails.size() / 2; i++) spec.replaceVar(leadingVars[i], tails[i]);
+  std::vector<const Monom*> specMonoms;
+  for (const Monom* mon : spec.getMonoms(false)) {
+    if (mon->getSize() > 0) specMonoms.push_back(mon);  // The benchmarks pick variables of these monomials.
+  }
+  sample_monoms(specMonoms, count, samples.monoms, rng);
+  std::vector<const Monom*> tailMonoms;
+  for (const std::list<Monom>& stepTail : tails) {
+    for (const Monom& mon : stepTail) tailMonoms.push_back(&mon);
+  }
+  sample_monoms(tailMonoms, count, samples.tails, rng);
+  samples.maxVar = std::max(samples.maxVar, file.getMaxVarIndex());
+}
+
+/**
+    Sample count monomials of each kind in total, evenly from all files.
+*/
+static void sample_files(const std::vector<std::string>& files, size_t count, MicroSamples& samples, std::mt19937& rng) {
+  std::streambuf* out = std::cout.rdbuf(NULL);
+  for (size_t i = 0; i < files.size(); i++) {
+    size_t share = count / files.size() + (i < count % files.size() ? 1 : 0);
+    if (BinaryStepFile::isBinary(files[i])) {
+      BinaryStepFile file(files[i]);
+      sample_file(file, [](BinaryStepFile & f, varIndex & leadingVar, std::list<Monom> & tail) {
+        return f.nextStep(leadingVar, tail);
+      }, share, samples, rng);
+    } else {
+      StepFile file(files[i]);
+      sample_file(file, [](StepFile & f, varIndex & leadingVar, std::list<Monom> & tail) {
+        const char* begin;
+        const char* end;
+        if (!f.nextStep(begin, end)) return false;
+        parse_step(begin, end, leadingVar, tail);
+        return true;
+      }, share, samples, rng);
+    }
+  }
+  std::cout.rdbuf(out);
+  std::cout.clear();
+}
+
+/**
+    Run round repeatedly until minTime seconds were measured. setup is called before every round and is not measured,
+    round returns the number of operations it performed.
+*/
+static MicroResult measure(const std::string& name, const MicroOptions& options, std::function<void()> setup, std::function<size_t()> round) {
+  MicroResult result;
+  result.name = name;
+  double seconds = 0;
+  size_t allocs = 0;
+  setup();
+  round();  // Warm-up.
+  while (seconds < options.minTime) {
+    setup();
+    size_t allocsBefore = allocations.load(std::memory_order_relaxed);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    result.ops += round();
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    allocs += allocations.load(std::memory_order_relaxed) - allocsBefore;
+    seconds += std::chrono::duration<double>(stop - start).count();
+  }
+  if (result.ops > 0) {
+    result.nsPerOp = seconds * 1e9 / result.ops;
+    result.allocsPerOp = (double)allocs / result.ops;
+  }
+  std::cerr << name << ": " << result.nsPerOp << " ns/op" << std::endl;
+  return result;
+}
+
+/**
+    Run all benchmarks on the samples.
+*/
+static std::vector<MicroResult> run_benchmarks(const MicroSamples& samples, const MicroOptions& options, std::mt19937& rng) {
+  std::vector<MicroResult> results;
+  const std::vector<Monom>& monoms = samples.monoms;
+  const std::vector<Monom>& tails = samples.tails;
+  size_t n = monoms.size();
+  auto nothing = []() {};
+
+  // Monomial kernels on random pairs of samples.
+  std::vector<varIndex> replace(n);
+  std::vector<size_t> partner(n);
+  std::vector<Monom> equal(n);
+  for (size_t i = 0; i < n; i++) {
+    replace[i] = monoms[i].getVars()[rng() % monoms[i].getSize()];
+    partner[i] = rng() % n;
+    equal[i] = (rng() % 2 == 0) ? monoms[i] : monoms[partner[i]];
+  }
+  results.push_back(measure("Monom::merge", options, nothing, [&]() {
+    for (size_t i = 0; i < n; i++) sink = sink + monoms[i].merge(replace[i], tails[partner[i] % tails.size()]).getSize();
+    return n;
+  }));
+  results.push_back(measure("Monom::multiply", options, nothing, [&]() {
+    for (size_t i = 0; i < n; i++) sink = sink + Monom::multiply(monoms[i], monoms[partner[i]]).getSize();
+    return n;
+  }));
+  results.push_back(measure("Monom::operator<", options, nothing, [&]() {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) count += (monoms[i] < monoms[partner[i]]);
+    sink = sink + count;
+    return n;
+  }));
+  results.push_back(measure("Monom::operator==", options, nothing, [&]() {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) count += (monoms[i] == equal[i]);
+    sink = sink + count;
+    return n;
+  }));
+
+  // Adding and erasing the samples, for both containers of the monomials.
+  for (int hash = 0; hash < 2; hash++) {
+    std::string backend = hash ? " (hash)" : " (set)";
+    Polynom* poly = NULL;
+    auto emptyPoly = [&]() {
+      delete poly;
+      poly = new Polynom(samples.maxVar + 1);
+      poly->setHashBackend(hash);
+    };
+    auto filledPoly = [&]() {
+      emptyPoly();
+      for (const Monom& mon : monoms) poly->addMonom(mon);
+    };
+    results.push_back(measure("Polynom::addMonom" + backend, options, emptyPoly, [&]() {
+      for (const Monom& mon : monoms) poly->addMonom(mon);
+      return n;
+    }));
+    std::vector<Monom> present;
+    results.push_back(measure("Polynom::eraseMonom" + backend, options, [&]() {
+      filledPoly();
+      std::vector<Monom*> contained = poly->getMonoms(false);
+      present.assign(contained.size(), Monom());
+      for (size_t i = 0; i < contained.size(); i++) present[i] = *contained[i];
+    }, [&]() {
+      for (const Monom& mon : present) poly->eraseMonom(mon);
+      return present.size();
+    }));
+    delete poly;
+  }
+
+  // Variable lists of the polynomial.
+  PolyArena arena;
+  MyList list;
+  list.setArena(&arena);
+  typedef decltype(list.add((Monom*)NULL)) ElementPtr;  // MyList::ListElement is private to the list.
+  std::vector<ElementPtr> elements(n);
+  std::vector<size_t> order(n);
+  for (size_t i = 0; i < n; i++) order[i] = i;
+  std::shuffle(order.begin(), order.end(), rng);
+  results.push_back(measure("MyList::add", options, [&]() {
+    for (ElementPtr element : elements) {
+      if (element != NULL) list.deleteElement(element);
+    }
+  }, [&]() {
+    for (size_t i = 0; i < n; i++) elements[i] = list.add(const_cast<Monom*>(&monoms[i]));
+    return n;
+  }));
+  results.push_back(measure("MyList::deleteElement", options, [&]() {
+    for (size_t i = 0; i < n; i++) elements[i] = list.add(const_cast<Monom*>(&monoms[i]));
+  }, [&]() {
+    for (size_t i : order) list.deleteElement(elements[i]);
+    return n;
+  }));
+  std::fill(elements.begin(), elements.end(), (ElementPtr)NULL);
+
+  // Lookups in a polynomial consisting of the samples. Half of the exact lookups miss.
+  Polynom poly(samples.maxVar + 1);
+  for (const Monom& mon : monoms) poly.addMonom(mon);
+  std::vector<Monom> containing(n);
+  std::vector<Monom> exact(n);
+  for (size_t i = 0; i < n; i++) {
+    const Monom& mon = monoms[partner[i]];
+    varIndex first = mon.getVars()[rng() % mon.getSize()];
+    varIndex second = mon.getVars()[rng() % mon.getSize()];
+    containing[i] = (first == second) ? Monom(first) : Monom(std::min(first, second), std::max(first, second));
+    exact[i] = (i % 2 == 0) ? monoms[i] : tails[i % tails.size()];
+  }
+  results.push_back(measure("Polynom::findContaining", options, nothing, [&]() {
+    for (size_t i = 0; i < n; i++) sink = sink + poly.findContaining(containing[i]).size();
+    return n;
+  }));
+  results.push_back(measure("Polynom::findExact", options, nothing, [&]() {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) count += (poly.findExact(exact[i]) != NULL);
+    sink = sink + count;
+    return n;
+  }));
+
+  // Negating a variable twice restores the polynomial, so the same polynomial is used for all rounds.
+  results.push_back(measure("Polynom::negateVarImproved", options, nothing, [&]() {
+    size_t rounds = std::min(n, (size_t)64);
+    for (size_t i = 0; i < rounds; i++) {
+      poly.negateVarImproved(replace[i]);
+      poly.negateVarImproved(replace[i]);
+    }
+    return 2 * rounds;
+  }));
+  results.push_back(measure("Polynom::to_string_opt", options, nothing, [&]() {
+    sink = sink + poly.to_string_opt().size();
+    return (size_t)1;
+  }));
+  return results;
+}
+
+/**
+    Write the results in the chosen format.
+*/
+static void write_results(std::ostream& out, const std::vector<MicroResult>& results, const MicroSamples& samples, const MicroOptions& options) {
+  if (options.format == "csv") {
+    out << "benchmark,ns_per_op,allocs_per_op,ops" << std::endl;
+    for (const MicroResult& result : results) {
+      out << result.name << "," << result.nsPerOp << "," << result.allocsPerOp << "," << result.ops << std::endl;
+    }
+  } else if (options.format == "json") {
+    out << "{\n";
+    out << "  \"samples\": " << samples.monoms.size() << ",\n";
+    out << "  \"seed\": " << options.seed << ",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+      out << (i == 0 ? "\n" : ",\n") << "    { \"benchmark\": \"" << results[i].name << "\", \"ns_per_op\": " << results[i].nsPerOp
+          << ", \"allocs_per_op\": " << results[i].allocsPerOp << ", \"ops\": " << results[i].ops << " }";
+    }
+    out << (results.empty() ? "]\n" : "\n  ]\n") << "}" << std::endl;
+  } else {
+    out << std::left << std::setw(36) << "benchmark" << std::right << std::setw(14) << "ns/op" << std::setw(14) << "allocs/op" << std::endl;
+    for (const MicroResult& result : results) {
+      out << std::left << std::setw(36) << result.name << std::right << std::fixed
+          << std::setw(14) << std::setprecision(1) << result.nsPerOp
+          << std::setw(14) << std::setprecision(2) << result.allocsPerOp << std::endl;
+    }
+  }
+}
+
+/**
+    Print the command line options.
+*/
+static void usage(const char* name) {
+  std::cerr << "usage: " << name << " [ <option> ... ] <step file or directory> ...\n"
+            << "\n"
+            << "where <option> is one of the following\n"
+            << "\n"
+            << "  -n <n>             sampled monomials (default 4096)\n"
+            << "  -t <seconds>       minimum measured time per benchmark (default 0.2)\n"
+            << "  -s <seed>          seed for sampling (default 1)\n"
+            << "  -f table|csv|json  output format (default table)\n"
+            << "\n"
+            << "The inputs are sampled from the given step files, directories are searched for step files." << std::endl;
+}
+
+/**
+    Main Function of the microbenchmarks. Usage: fastpoly_microbench [ <option> ... ] <step file or directory> ...
+
+*/
+int main(int argc, char ** argv) {
+  mp_set_memory_functions(gmp_allocate, gmp_reallocate, gmp_free);
+  MicroOptions options;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = (i + 1 < argc);
+    if (arg == "-h" || arg == "--help") {
+      usage(argv[0]);
+      return 0;
+    } else if (arg == "-n" && hasValue) {
+      options.samples = std::max(2, std::atoi(argv[++i]));
+    } else if (arg == "-t" && hasValue) {
+      options.minTime = std::atof(argv[++i]);
+    } else if (arg == "-s" && hasValue) {
+      options.seed = std::strtoul(argv[++i], NULL, 10);
+    } else if (arg == "-f" && hasValue) {
+      options.format = argv[++i];
+      if (options.format != "table" && options.format != "csv" && options.format != "json") {
+        std::cerr << "invalid format '" << options.format << "' (try '-h')" << std::endl;
+        return 1;
+      }
+    } else if (arg[0] == '-') {
+      std::cerr << "invalid option '" << arg << "' (try '-h')" << std::endl;
+      return 1;
+    } else if (!collect_files(arg, files)) {
+      return 1;
+    }
+  }
+  if (files.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  std::mt19937 rng(options.seed);
+  MicroSamples samples;
+  sample_files(files, options.samples, samples, rng);
+  if (samples.monoms.empty() || samples.tails.empty()) {
+    std::cerr << "The step files contain no monomials to sample." << std::endl;
+    return 1;
+  }
+  std::vector<MicroResult> results = run_benchmarks(samples, options, rng);
+  write_results(std::cout, results, samples, options);
+  return 0;
+}
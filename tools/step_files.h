@@ -0,0 +1,73 @@
+/*------------------------------------------------------------------------*/
+/*! \file step_files.h
+    \brief contains helpers of the benchmark tools for collecting step files
+    from the command line.
+
+  Part of FastPoly : A Polynomial Package For Efficient Polynomial Reduction.
+  Copyright(C) 2025 Alexander Konrad, University of Freiburg
+*/
+/*------------------------------------------------------------------------*/
+
+#ifndef STEP_FILES_H_
+#define STEP_FILES_H_
+
+// std includes.
+#include <algorithm>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+// Local includes.
+#include "binary_step_file.h"
+
+/**
+    Return whether the file looks like a step file: either in the binary format or starting with the maximum variable index.
+*/
+inline bool is_step_file(const std::string& path) {
+  if (BinaryStepFile::isBinary(path)) return true;
+  std::ifstream in(path);
+  std::string line;
+  if (!std::getline(in, line)) return false;
+  if (!line.empty() && line.back() == '\r') line.pop_back();
+  return !line.empty() && std::all_of(line.begin(), line.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+/**
+    Append the file, or all step files of the directory in name order, to files.
+*/
+inline bool collect_files(const std::string& path, std::vector<std::string>& files) {
+  struct stat info;
+  if (stat(path.c_str(), &info) != 0) {
+    std::cerr << "Error opening file " << path << ". Make sure the filename is correct." << std::endl;
+    return false;
+  }
+  if (!S_ISDIR(info.st_mode)) {
+    if (!is_step_file(path)) {
+      std::cerr << "Error reading file " << path << ". It is not a step file." << std::endl;
+      return false;
+    }
+    files.push_back(path);
+    return true;
+  }
+  DIR* dir = opendir(path.c_str());
+  if (dir == NULL) {
+    std::cerr << "Error opening directory " << path << "." << std::endl;
+    return false;
+  }
+  std::vector<std::string> entries;
+  std::string prefix = (path.back() == '/') ? path : path + "/";
+  while (struct dirent* entry = readdir(dir)) {
+    std::string file = prefix + entry->d_name;
+    if (entry->d_name[0] == '.' || stat(file.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) continue;
+    if (is_step_file(file)) entries.push_back(file);
+  }
+  closedir(dir);
+  std::sort(entries.begin(), entries.end());
+  files.insert(files.end(), entries.begin(), entries.end());
+  return true;
+}
+
+#endif /* STEP_FILES_H_ */